@@ -1,13 +1,17 @@
 import os
 from uuid import uuid4
-from fastapi import FastAPI, UploadFile, File, HTTPException
+from fastapi import FastAPI, UploadFile, File, HTTPException, Request
 from fastapi.responses import HTMLResponse, FileResponse
 from fastapi.middleware.cors import CORSMiddleware
 from ultralytics import YOLO
+from collections import deque
+from datetime import datetime, timedelta
 from pydantic import BaseModel
 from PIL import Image
 import uuid
 
+from telemetry_schema import DHT_BATCH_MAX, DHTBatch, read_telemetry
+
 # ============================================
 # DEFINISIKAN FASTAPI APP  **FIX**
 # ============================================
@@ -280,3 +284,62 @@ def post_dht(data: DHTData):
 @app.get("/sensor/dht")
 def get_dht():
     return dht_state
+
+# =====================================================================
+# Endpoint DHT batch (N sampel / T detik per request)
+# =====================================================================
+# DHTSample / DHTBatch di telemetry_schema.py
+dht_history = deque(maxlen=1000)
+
+def sample_time(now, s):
+    if s.age_ms is None:
+        return None
+    return (now - timedelta(milliseconds=s.age_ms)).isoformat()
+
+@app.post("/sensor/dht/batch")
+def post_dht_batch(batch: DHTBatch):
+    if not batch.samples or len(batch.samples) > DHT_BATCH_MAX:
+        raise HTTPException(status_code=422, detail="samples must be 1..%d" % DHT_BATCH_MAX)
+
+    now = datetime.now()
+    rows = [{
+        "device": batch.device,
+        "boot": batch.boot,
+        "seq": s.seq,
+        "temperature": s.temperature,
+        "humidity": s.humidity,
+        "timestamp": sample_time(now, s),
+    } for s in batch.samples]
+
+    dht_history.extend(rows)
+
+    last = batch.samples[-1]
+    dht_state.update({"device": batch.device,
+                      "temperature": last.temperature,
+                      "humidity": last.humidity})
+
+    return {"status": "ok", "stored": len(rows)}
+
+# =====================================================================
+# Endpoint Telemetry kontrol (biner atau JSON)
+# =====================================================================
+# skema frame & decoder di telemetry_schema.py
+telemetry_history = deque(maxlen=5000)
+
+@app.post("/telemetry")
+async def post_telemetry(request: Request, device: str = "robot-01"):
+    device, boot, cols = await read_telemetry(request, device)
+
+    n = len(cols["t_ms"])
+    keys = list(cols.keys())
+    values = [cols[k].tolist() for k in keys]
+    telemetry_history.extend(
+        dict(device=device, boot=boot, **dict(zip(keys, row)))
+        for row in zip(*values))
+
+    return {"status": "ok", "stored": n}
+
+@app.get("/telemetry")
+def get_telemetry(limit: int = 100):
+    limit = max(0, min(limit, len(telemetry_history)))
+    return list(telemetry_history)[-limit:] if limit else []
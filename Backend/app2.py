@@ -1,14 +1,18 @@
 import os
+import json
 import sqlite3
-from datetime import datetime
+from datetime import datetime, timedelta
+from typing import Optional
 from uuid import uuid4
-from fastapi import FastAPI, UploadFile, File, HTTPException
+from fastapi import FastAPI, UploadFile, File, HTTPException, Request, WebSocket, WebSocketDisconnect
 from fastapi.responses import HTMLResponse, FileResponse
 from fastapi.middleware.cors import CORSMiddleware
 from ultralytics import YOLO
-from pydantic import BaseModel
+from pydantic import BaseModel, Field
 from PIL import Image
 
+from telemetry_schema import DHT_BATCH_MAX, DHTBatch, decode_telemetry, read_telemetry
+
 
 # ================================================================
 # FASTAPI APP
@@ -56,6 +60,57 @@ def init_db():
         )
     """)
 
+    cur.execute("""
+        CREATE TABLE IF NOT EXISTS dht_samples (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            device TEXT NOT NULL,
+            boot INTEGER,
+            seq INTEGER,
+            temperature REAL,
+            humidity REAL,
+            timestamp TEXT,
+            received TEXT
+        )
+    """)
+
+    cur.execute("""
+        CREATE TABLE IF NOT EXISTS control_samples (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            device TEXT NOT NULL,
+            boot INTEGER,
+            t_ms INTEGER,
+            pos INTEGER,
+            left_cmd INTEGER,
+            right_cmd INTEGER,
+            dist_cm INTEGER,
+            state INTEGER,
+            received TEXT
+        )
+    """)
+
+    # pot dari replay journal robot (offline): riwayat saja
+    cur.execute("""
+        CREATE TABLE IF NOT EXISTS pot_history (
+            id INTEGER PRIMARY KEY AUTOINCREMENT,
+            device TEXT NOT NULL,
+            boot INTEGER,
+            seq INTEGER,
+            pot INTEGER,
+            timestamp TEXT,
+            received TEXT
+        )
+    """)
+
+    # replay journal bisa terkirim dua kali: (device, boot, seq) unik
+    cur.execute("""
+        CREATE UNIQUE INDEX IF NOT EXISTS dht_samples_seq
+        ON dht_samples (device, boot, seq)
+    """)
+    cur.execute("""
+        CREATE UNIQUE INDEX IF NOT EXISTS pot_history_seq
+        ON pot_history (device, boot, seq)
+    """)
+
     conn.commit()
     conn.close()
 
@@ -164,13 +219,127 @@ class PotData(BaseModel):
     pot: int
 
 
+def set_current_pot(pot):
+    current_pot["pot"] = pot
+    add_log(f"Scanning POT ({pot})")
+
+
 @app.post("/pot")
 def post_pot(data: PotData):
-    current_pot["pot"] = data.pot
-    add_log(f"Scanning POT ({data.pot})")
+    set_current_pot(data.pot)
     return {"status": "ok", "pot": data.pot}
 
 
+# ================================================================
+# RIWAYAT POT (replay journal robot, tidak mengubah current_pot)
+# ================================================================
+class PotHistory(BaseModel):
+    device: str
+    boot: int = 0
+    seq: int
+    pot: int
+    age_ms: Optional[int] = Field(None, ge=0)   # hanya jika boot yang sama
+
+
+def save_pot_history(data, now):
+    ts = None
+    if data.age_ms is not None:
+        ts = (now - timedelta(milliseconds=data.age_ms)).isoformat()
+
+    conn = db_connect()
+    try:
+        with conn:
+            before = conn.total_changes
+            conn.execute("""
+                INSERT OR IGNORE INTO pot_history
+                (device, boot, seq, pot, timestamp, received)
+                VALUES (?, ?, ?, ?, ?, ?)
+            """, (data.device, data.boot, data.seq, data.pot, ts, now.isoformat()))
+            return conn.total_changes - before
+    finally:
+        conn.close()
+
+
+@app.post("/pot/history")
+def post_pot_history(data: PotHistory):
+    stored = save_pot_history(data, datetime.now())
+    if stored:
+        add_log(f"POT ({data.pot}) offline tercatat (boot {data.boot}, seq {data.seq})")
+    return {"status": "ok", "stored": stored}
+
+
+@app.get("/pot/history")
+def get_pot_history(limit: int = 100):
+    conn = db_connect()
+    try:
+        rows = conn.execute("""
+            SELECT device, boot, seq, pot, timestamp, received FROM pot_history
+            ORDER BY id DESC LIMIT ?
+        """, (limit,)).fetchall()
+    finally:
+        conn.close()
+    return [dict(r) for r in rows]
+
+
+# ================================================================
+# WEBSOCKET ROBOT (pot + telemetry masuk, hasil analisis keluar)
+# ================================================================
+robot_sockets = set()
+
+
+async def notify_robots(msg):
+    for ws in list(robot_sockets):
+        try:
+            await ws.send_json(msg)
+        except Exception:
+            robot_sockets.discard(ws)
+
+
+@app.websocket("/ws/robot")
+async def ws_robot(ws: WebSocket, device: str = "robot-01"):
+    await ws.accept()
+    robot_sockets.add(ws)
+    add_log("Robot connected (ws)")
+
+    try:
+        while True:
+            msg = await ws.receive()
+            if msg["type"] == "websocket.disconnect":
+                break
+
+            # biner = frame telemetry (lihat decode_telemetry)
+            if msg.get("bytes") is not None:
+                try:
+                    boot, cols = decode_telemetry(msg["bytes"])
+                    save_control_samples(device, boot, cols, datetime.now())
+                except HTTPException as e:
+                    add_log(f"WS telemetry ditolak: {e.detail}")
+                continue
+
+            try:
+                data = json.loads(msg.get("text") or "")
+            except ValueError:
+                continue
+
+            if data.get("type") == "pot" and isinstance(data.get("pot"), int):
+                set_current_pot(data["pot"])
+                await ws.send_json({"type": "ack", "pot": data["pot"]})
+
+    except WebSocketDisconnect:
+        pass
+    finally:
+        robot_sockets.discard(ws)
+        add_log("Robot disconnected (ws)")
+
+
+@app.post("/robot/resume")
+async def robot_resume():
+    """Keluarkan robot dari ROBOT_ERROR (mis. garis hilang) tanpa reboot."""
+    await notify_robots({"type": "resume"})
+    add_log(f"Resume dikirim ke {len(robot_sockets)} robot")
+    return {"status": "ok", "robots": len(robot_sockets)}
+
+
 # ================================================================
 # UPLOAD DETEKSI CABAI
 # ================================================================
@@ -225,6 +394,16 @@ async def upload_chili(file: UploadFile = File(...)):
         # simpan ke SQLite
         save_pot_detection(pot_id, ripe, unripe, total)
 
+        # push ke robot, tidak perlu polling
+        await notify_robots({
+            "type": "analysis",
+            "pot": pot_id,
+            "ripeness": ripeness,
+            "ripe": ripe,
+            "unripe": unripe,
+            "total": total,
+        })
+
     return {
         "status": "ok",
         "ripeness": ripeness,
@@ -343,6 +522,89 @@ def post_dht(data: DHTData):
 def get_dht():
     return dht_state
 
+
+# ================================================================
+# DHT BATCH API (N sampel / T detik per request)
+# ================================================================
+# DHTSample / DHTBatch di telemetry_schema.py
+def save_dht_batch(batch, now):
+    rows = []
+    for s in batch.samples:
+        ts = None
+        if s.age_ms is not None:
+            ts = (now - timedelta(milliseconds=s.age_ms)).isoformat()
+        rows.append((batch.device, batch.boot, s.seq,
+                     s.temperature, s.humidity, ts, now.isoformat()))
+
+    conn = db_connect()
+    try:
+        # satu transaksi: semua masuk atau tidak sama sekali
+        with conn:
+            before = conn.total_changes
+            conn.executemany("""
+                INSERT OR IGNORE INTO dht_samples
+                (device, boot, seq, temperature, humidity, timestamp, received)
+                VALUES (?, ?, ?, ?, ?, ?, ?)
+            """, rows)
+            return conn.total_changes - before
+    finally:
+        conn.close()
+
+
+@app.post("/sensor/dht/batch")
+def post_dht_batch(batch: DHTBatch):
+    if not batch.samples or len(batch.samples) > DHT_BATCH_MAX:
+        raise HTTPException(status_code=422, detail="samples must be 1..%d" % DHT_BATCH_MAX)
+
+    stored = save_dht_batch(batch, datetime.now())
+
+    last = batch.samples[-1]
+    dht_state.update({"device": batch.device,
+                      "temperature": last.temperature,
+                      "humidity": last.humidity})
+
+    return {"status": "ok", "stored": stored, "received": len(batch.samples)}
+
+# ================================================================
+# TELEMETRY KONTROL API (biner atau JSON)
+# ================================================================
+# skema frame & decoder di telemetry_schema.py
+def save_control_samples(device, boot, cols, now):
+    rows = zip([device] * len(cols["t_ms"]), [boot] * len(cols["t_ms"]),
+               cols["t_ms"].tolist(), cols["pos"].tolist(),
+               cols["left"].tolist(), cols["right"].tolist(),
+               cols["dist_cm"].tolist(), cols["state"].tolist(),
+               [now.isoformat()] * len(cols["t_ms"]))
+
+    conn = db_connect()
+    try:
+        with conn:
+            conn.executemany("""
+                INSERT INTO control_samples
+                (device, boot, t_ms, pos, left_cmd, right_cmd, dist_cm, state, received)
+                VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?)
+            """, rows)
+    finally:
+        conn.close()
+
+
+@app.post("/telemetry")
+async def post_telemetry(request: Request, device: str = "robot-01"):
+    device, boot, cols = await read_telemetry(request, device)
+    save_control_samples(device, boot, cols, datetime.now())
+    return {"status": "ok", "stored": len(cols["t_ms"])}
+
+
+@app.get("/telemetry")
+def get_telemetry(limit: int = 100):
+    conn = db_connect()
+    rows = conn.execute("""
+        SELECT * FROM control_samples ORDER BY id DESC LIMIT ?
+    """, (limit,)).fetchall()
+    conn.close()
+    return [dict(r) for r in reversed(rows)]
+
+
 # ============================================
 # Halaman Web Viewer
 # ============================================
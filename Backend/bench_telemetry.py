@@ -0,0 +1,142 @@
+"""
+Benchmark frame telemetry kontrol: biner (telemetry.h) vs JSON (ControlBatch).
+
+Ukuran per frame, waktu encode dan decode per frame. Skema dan decoder numpy
+diambil dari telemetry_schema.py (yang dipakai app.py / app2.py), jadi yang
+diukur adalah decode_telemetry() backend itu sendiri. Butuh requirements.txt.
+
+    python bench_telemetry.py                  # 25 rec (1 s @ 25 Hz) dan 64 rec (ring penuh)
+    python bench_telemetry.py -n 25 -r 5000
+"""
+import argparse
+import json
+import random
+import timeit
+
+from telemetry_schema import (TELEM_FIELDS as FIELDS, TELEM_HDR_STRUCT as HDR,
+                              TELEM_REC_STRUCT as REC, TELEM_TYPE_CONTROL,
+                              TELEM_VER, decode_telemetry)
+
+
+# ============================================
+# DATA: sampel loop kontrol 25 Hz (TELEM_DECIM)
+# ============================================
+def make_samples(n, t0=123456, seed=1):
+    rnd = random.Random(seed)
+    out = []
+    for i in range(n):
+        pos = rnd.randint(2500, 4500) if rnd.random() > 0.02 else -1
+        out.append({
+            "t_ms": t0 + 40 * i,
+            "pos": pos,
+            "left": rnd.randint(3000, 8191),
+            "right": rnd.randint(3000, 8191),
+            "dist_cm": rnd.randint(2, 400) if rnd.random() > 0.3 else -1,
+            "state": 1,
+        })
+    return out
+
+
+# ============================================
+# BINER
+# ============================================
+def encode_bin(samples, boot):
+    t0 = samples[0]["t_ms"]
+    parts = [HDR.pack(b"TL", TELEM_VER, TELEM_TYPE_CONTROL, len(samples), boot, t0)]
+    for s in samples:
+        parts.append(REC.pack(min(s["t_ms"] - t0, 0xFFFF), s["pos"], s["left"],
+                              s["right"], s["dist_cm"], s["state"], 0))
+    return b"".join(parts)
+
+
+def decode_bin(raw):
+    magic, ver, typ, count, boot, t0 = HDR.unpack_from(raw)
+    if magic != b"TL" or ver != TELEM_VER or typ != TELEM_TYPE_CONTROL:
+        raise ValueError("bad header")
+    if len(raw) != HDR.size + count * REC.size:
+        raise ValueError("bad length")
+
+    cols = {k: [] for k in FIELDS}
+    for dt, pos, left, right, dist, state, _ in REC.iter_unpack(raw[HDR.size:]):
+        cols["t_ms"].append(t0 + dt)
+        cols["pos"].append(pos)
+        cols["left"].append(left)
+        cols["right"].append(right)
+        cols["dist_cm"].append(dist)
+        cols["state"].append(state)
+    return boot, cols
+
+
+# ============================================
+# JSON (klien lama: {device, boot, samples:[...]})
+# ============================================
+def encode_json(samples, boot, device="robot-01"):
+    return json.dumps({"device": device, "boot": boot, "samples": samples},
+                      separators=(",", ":")).encode()
+
+
+def decode_json(raw):
+    data = json.loads(raw)
+    cols = {k: [s[k] for s in data["samples"]] for k in FIELDS}
+    return data["boot"], cols
+
+
+# ============================================
+# BENCHMARK
+# ============================================
+def per_call_us(fn, repeat):
+    best = min(timeit.repeat(fn, number=repeat, repeat=3))
+    return best / repeat * 1e6
+
+
+def check(samples, boot, decoded):
+    got_boot, cols = decoded
+    assert got_boot == boot
+    for k in FIELDS:
+        assert [int(v) for v in cols[k]] == [s[k] for s in samples], k
+
+
+def bench(n, repeat, boot=7):
+    samples = make_samples(n)
+    raw_bin = encode_bin(samples, boot)
+    raw_json = encode_json(samples, boot)
+
+    check(samples, boot, decode_bin(raw_bin))
+    check(samples, boot, decode_json(raw_json))
+    check(samples, boot, decode_telemetry(raw_bin))
+
+    assert len(raw_bin) == HDR.size + n * REC.size
+
+    rows = [
+        ("json", len(raw_json),
+         per_call_us(lambda: encode_json(samples, boot), repeat),
+         per_call_us(lambda: decode_json(raw_json), repeat)),
+        ("biner struct", len(raw_bin),
+         per_call_us(lambda: encode_bin(samples, boot), repeat),
+         per_call_us(lambda: decode_bin(raw_bin), repeat)),
+        ("biner numpy", len(raw_bin), None,
+         per_call_us(lambda: decode_telemetry(raw_bin), repeat)),
+    ]
+
+    print(f"\n== {n} record / frame, {repeat} x ==")
+    print(f"{'format':<14}{'byte':>7}{'byte/rec':>10}{'encode us':>11}{'decode us':>11}")
+    for name, size, enc, dec in rows:
+        enc_s = f"{enc:11.1f}" if enc is not None else f"{'-':>11}"
+        print(f"{name:<14}{size:7d}{size / n:10.1f}{enc_s}{dec:11.1f}")
+
+    print(f"json / biner: ukuran {len(raw_json) / len(raw_bin):.1f}x")
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("-n", type=int, action="append",
+                    help="record per frame (boleh berulang)")
+    ap.add_argument("-r", "--repeat", type=int, default=2000)
+    args = ap.parse_args()
+
+    for n in args.n or [25, 64]:
+        bench(n, args.repeat)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,122 @@
+"""
+Skema data robot yang dipakai bersama app.py, app2.py dan bench_telemetry.py.
+
+- frame telemetry kontrol biner (sama dengan Kontrol-Robot/main/telemetry.h)
+  dan versi JSON lamanya (ControlBatch)
+- batch DHT dari wifi_http.c (DHTSample / DHTBatch)
+
+Ubah skema hanya di sini.
+"""
+import struct
+from typing import List, Optional
+
+import numpy as np
+from fastapi import HTTPException
+from pydantic import BaseModel, Field, ValidationError
+
+
+# ============================================
+# TELEMETRY KONTROL: FRAME BINER
+# ============================================
+TELEM_VER = 1
+TELEM_TYPE_CONTROL = 1
+TELEM_MAX_REC = 1024
+
+# skema tetap little-endian, sama dengan Kontrol-Robot/main/telemetry.h
+TELEM_HDR = np.dtype([
+    ("magic", "S2"), ("ver", "u1"), ("type", "u1"),
+    ("count", "<u2"), ("boot", "<u2"), ("t0_ms", "<u4"),
+])
+TELEM_CONTROL = np.dtype([
+    ("dt_ms", "<u2"), ("pos", "<i2"), ("left", "<i2"), ("right", "<i2"),
+    ("dist_cm", "<i2"), ("state", "u1"), ("rsv", "u1"),
+])
+
+# layout yang sama untuk encoder / decoder tanpa numpy
+TELEM_HDR_STRUCT = struct.Struct("<2sBBHHI")      # magic, ver, type, count, boot, t0_ms
+TELEM_REC_STRUCT = struct.Struct("<HhhhhBB")      # dt_ms, pos, left, right, dist_cm, state, rsv
+
+assert TELEM_HDR_STRUCT.size == TELEM_HDR.itemsize
+assert TELEM_REC_STRUCT.size == TELEM_CONTROL.itemsize
+
+TELEM_FIELDS = ("t_ms", "pos", "left", "right", "dist_cm", "state")
+
+
+def decode_telemetry(raw):
+    """Frame biner -> (boot, dict kolom numpy). Tanpa loop per record."""
+    if len(raw) < TELEM_HDR.itemsize:
+        raise HTTPException(status_code=400, detail="short frame")
+
+    hdr = np.frombuffer(raw, TELEM_HDR, count=1)[0]
+    if hdr["magic"] != b"TL" or hdr["ver"] != TELEM_VER or hdr["type"] != TELEM_TYPE_CONTROL:
+        raise HTTPException(status_code=400, detail="bad header")
+
+    count = int(hdr["count"])
+    if count > TELEM_MAX_REC or len(raw) != TELEM_HDR.itemsize + count * TELEM_CONTROL.itemsize:
+        raise HTTPException(status_code=400, detail="bad length")
+
+    rec = np.frombuffer(raw, TELEM_CONTROL, count=count, offset=TELEM_HDR.itemsize)
+    cols = {name: rec[name] for name in ("pos", "left", "right", "dist_cm", "state")}
+    cols["t_ms"] = rec["dt_ms"].astype(np.uint32) + np.uint32(hdr["t0_ms"])
+    return int(hdr["boot"]), cols
+
+
+# ============================================
+# TELEMETRY KONTROL: JSON (klien lama)
+# ============================================
+class ControlSample(BaseModel):
+    t_ms: int
+    pos: int
+    left: int
+    right: int
+    dist_cm: int
+    state: int
+
+
+class ControlBatch(BaseModel):
+    device: str
+    boot: int = 0
+    samples: List[ControlSample]
+
+
+def decode_telemetry_json(data):
+    """Klien lama: JSON {device, boot, samples:[...]} -> kolom yang sama."""
+    try:
+        batch = ControlBatch(**data)
+    except ValidationError as e:
+        raise HTTPException(status_code=422, detail=e.errors())
+
+    if len(batch.samples) > TELEM_MAX_REC:
+        raise HTTPException(status_code=422, detail="too many samples")
+
+    cols = {name: np.array([getattr(s, name) for s in batch.samples])
+            for name in TELEM_FIELDS}
+    return batch.device, batch.boot, cols
+
+
+async def read_telemetry(request, device):
+    """application/octet-stream = biner, selain itu JSON."""
+    ctype = request.headers.get("content-type", "")
+    if ctype.startswith("application/octet-stream"):
+        boot, cols = decode_telemetry(await request.body())
+        return device, boot, cols
+    return decode_telemetry_json(await request.json())
+
+
+# ============================================
+# DHT BATCH (N sampel / T detik per request)
+# ============================================
+DHT_BATCH_MAX = 256
+
+
+class DHTSample(BaseModel):
+    temperature: float = Field(..., ge=-40, le=80)
+    humidity: float = Field(..., ge=0, le=100)
+    age_ms: Optional[int] = Field(None, ge=0)   # umur sampel saat dikirim
+    seq: Optional[int] = None                   # nomor journal (replay)
+
+
+class DHTBatch(BaseModel):
+    device: str
+    boot: int = 0
+    samples: List[DHTSample]
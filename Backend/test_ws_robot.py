@@ -0,0 +1,160 @@
+"""
+Test /ws/robot (app2.py) dengan fastapi.testclient, tanpa server / robot asli.
+
+- pot lewat ws -> ack, current_pot berubah
+- push dari backend: POST /robot/resume dan /chili/upload (notify_robots)
+- frame telemetry biner lewat ws -> save_control_samples (tabel control_samples)
+
+Model YOLO diganti tiruan; database dan upload di direktori sementara.
+
+    python test_ws_robot.py        # atau: pytest test_ws_robot.py
+
+Butuh requirements.txt + httpx (dipakai TestClient).
+"""
+import io
+import os
+import sqlite3
+import sys
+import tempfile
+import types
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+sys.path.insert(0, HERE)
+
+
+# ============================================
+# YOLO TIRUAN (ultralytics tidak di-load)
+# ============================================
+class FakeBox:
+    def __init__(self, cls, conf):
+        self.cls = cls
+        self.conf = conf
+
+
+class FakeResult:
+    boxes = [FakeBox(0, 0.9), FakeBox(0, 0.7), FakeBox(1, 0.5)]   # 2 ripe, 1 unripe
+
+    def save(self, filename):
+        pass
+
+
+class FakeYOLO:
+    def __init__(self, path):
+        self.path = path
+
+    def predict(self, path, verbose=False):
+        return [FakeResult()]
+
+
+sys.modules["ultralytics"] = types.SimpleNamespace(YOLO=FakeYOLO)
+
+# chili.db dan chili_uploads dibuat relatif ke cwd saat import
+os.chdir(tempfile.mkdtemp(prefix="ws_robot_"))
+
+from fastapi.testclient import TestClient  # noqa: E402
+from PIL import Image  # noqa: E402
+
+import app2  # noqa: E402
+from bench_telemetry import encode_bin, make_samples  # noqa: E402
+
+WS_URL = "/ws/robot?device=robot-test"
+
+
+def jpeg_bytes():
+    buf = io.BytesIO()
+    Image.new("RGB", (8, 8)).save(buf, format="JPEG")
+    return buf.getvalue()
+
+
+def control_rows(device):
+    conn = sqlite3.connect(app2.DB_PATH)
+    try:
+        return conn.execute("SELECT boot, t_ms, pos, left_cmd, right_cmd, dist_cm, state "
+                            "FROM control_samples WHERE device = ? ORDER BY id",
+                            (device,)).fetchall()
+    finally:
+        conn.close()
+
+
+# ============================================
+# TEST
+# ============================================
+def test_pot_ack():
+    with TestClient(app2.app) as client:
+        with client.websocket_connect(WS_URL) as ws:
+            ws.send_json({"type": "pot", "pot": 3})
+            assert ws.receive_json() == {"type": "ack", "pot": 3}
+            assert app2.current_pot["pot"] == 3
+
+            # pot bukan int: diabaikan, tanpa ack
+            ws.send_json({"type": "pot", "pot": "x"})
+            ws.send_json({"type": "pot", "pot": 4})
+            assert ws.receive_json() == {"type": "ack", "pot": 4}
+
+
+def test_push_resume():
+    with TestClient(app2.app) as client:
+        with client.websocket_connect(WS_URL) as ws:
+            ws.send_json({"type": "pot", "pot": 1})
+            ws.receive_json()      # ack: socket sudah terdaftar di robot_sockets
+
+            resp = client.post("/robot/resume")
+            assert resp.status_code == 200 and resp.json()["robots"] == 1
+            assert ws.receive_json() == {"type": "resume"}
+
+
+def test_push_analysis():
+    with TestClient(app2.app) as client:
+        with client.websocket_connect(WS_URL) as ws:
+            ws.send_json({"type": "pot", "pot": 5})
+            assert ws.receive_json()["type"] == "ack"
+
+            resp = client.post("/chili/upload",
+                               files={"file": ("capture.jpg", jpeg_bytes(), "image/jpeg")})
+            assert resp.status_code == 200 and resp.json()["pot"] == 5
+
+            msg = ws.receive_json()
+            assert msg == {"type": "analysis", "pot": 5, "ripeness": 0,
+                           "ripe": 2, "unripe": 1, "total": 3}
+
+
+def test_telemetry_frame():
+    samples = make_samples(25)
+    before = len(control_rows("robot-test"))
+
+    with TestClient(app2.app) as client:
+        with client.websocket_connect(WS_URL) as ws:
+            ws.send_bytes(encode_bin(samples, boot=9))
+
+            # frame rusak: ditolak dan dicatat, koneksi tetap hidup
+            ws.send_bytes(b"XX" + bytes(10))
+
+            # ack = pesan sebelumnya sudah diproses (satu receive loop)
+            ws.send_json({"type": "pot", "pot": 2})
+            assert ws.receive_json() == {"type": "ack", "pot": 2}
+
+    rows = control_rows("robot-test")[before:]
+    assert len(rows) == len(samples)
+    for row, s in zip(rows, samples):
+        assert row == (9, s["t_ms"], s["pos"], s["left"], s["right"], s["dist_cm"], s["state"])
+
+
+def main():
+    tests = [test_pot_ack, test_push_resume, test_push_analysis, test_telemetry_frame]
+    failed = 0
+    for t in tests:
+        try:
+            t()
+            print(f"{t.__name__:<22} OK")
+        except AssertionError as e:
+            failed += 1
+            print(f"{t.__name__:<22} GAGAL {e}")
+
+    if failed:
+        print(f"{failed} test gagal")
+        sys.exit(1)
+    print("OK")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,132 @@
+"""
+Klien uji /ws/robot (app2.py): berperan sebagai robot.
+
+Kirim event pot {"type":"pot","pot":N}, tunggu ack, lalu tunggu push
+{"type":"analysis"} untuk pot yang sama. Dengan --image, gambar di-upload
+ke /chili/upload seperti ESP32-CAM; tanpa --image, tunggu kamera asli.
+Exit 0 jika analysis diterima, 1 jika gagal / timeout.
+
+    python ws_test_client.py --pot 3 --image sample.jpg
+    python ws_test_client.py --host leafiot.ksmiotupnvj.com:8000 --pot 1 --timeout 60
+
+Butuh requirements.txt backend (websockets ikut uvicorn[standard]; numpy untuk
+bench_telemetry / telemetry_schema).
+"""
+import argparse
+import asyncio
+import json
+import sys
+import time
+import urllib.request
+from uuid import uuid4
+
+import websockets
+
+from bench_telemetry import encode_bin, make_samples
+
+
+# ============================================
+# UPLOAD (multipart, seperti ESP32-CAM)
+# ============================================
+def upload_image(base_url, path):
+    with open(path, "rb") as f:
+        img = f.read()
+
+    boundary = uuid4().hex
+    body = b"".join([
+        f"--{boundary}\r\n".encode(),
+        b'Content-Disposition: form-data; name="file"; filename="capture.jpg"\r\n',
+        b"Content-Type: image/jpeg\r\n\r\n",
+        img,
+        f"\r\n--{boundary}--\r\n".encode(),
+    ])
+    req = urllib.request.Request(
+        f"{base_url}/chili/upload", data=body, method="POST",
+        headers={"Content-Type": f"multipart/form-data; boundary={boundary}"})
+
+    with urllib.request.urlopen(req, timeout=60) as resp:
+        return json.loads(resp.read())
+
+
+# ============================================
+# WEBSOCKET
+# ============================================
+async def recv_type(ws, want, pot, deadline):
+    """Pesan teks pertama dengan type == want untuk pot ini; lainnya dicetak."""
+    while True:
+        left = deadline - time.monotonic()
+        if left <= 0:
+            raise asyncio.TimeoutError
+        raw = await asyncio.wait_for(ws.recv(), left)
+        if isinstance(raw, bytes):
+            continue
+
+        msg = json.loads(raw)
+        if msg.get("type") == want and msg.get("pot") == pot:
+            return msg
+        print(f"  (lewati) {msg}")
+
+
+async def run(args):
+    base_url = f"http://{args.host}"
+    ws_url = f"ws://{args.host}/ws/robot?device={args.device}"
+    deadline = time.monotonic() + args.timeout
+
+    async with websockets.connect(ws_url, open_timeout=args.timeout) as ws:
+        print(f"tersambung {ws_url}")
+
+        if args.telemetry:
+            frame = encode_bin(make_samples(25), boot=1)
+            await ws.send(frame)
+            print(f"telemetry {len(frame)} byte terkirim")
+
+        t0 = time.monotonic()
+        await ws.send(json.dumps({"type": "pot", "pot": args.pot}))
+        ack = await recv_type(ws, "ack", args.pot, deadline)
+        print(f"ack      {(time.monotonic() - t0) * 1000:7.1f} ms  {ack}")
+
+        upload = None
+        if args.image:
+            loop = asyncio.get_running_loop()
+            upload = loop.run_in_executor(None, upload_image, base_url, args.image)
+        else:
+            print("menunggu upload kamera ...")
+
+        res = await recv_type(ws, "analysis", args.pot, deadline)
+        print(f"analysis {(time.monotonic() - t0) * 1000:7.1f} ms  {res}")
+
+        if upload is not None:
+            resp = await upload
+            if resp.get("pot") != args.pot:
+                print(f"upload dicatat untuk pot {resp.get('pot')}, bukan {args.pot}")
+                return False
+
+        return True
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument("--host", default="127.0.0.1:8000")
+    ap.add_argument("--device", default="robot-test")
+    ap.add_argument("--pot", type=int, default=1)
+    ap.add_argument("--image", help="jpg untuk /chili/upload")
+    ap.add_argument("--telemetry", action="store_true",
+                    help="kirim juga 1 frame telemetry biner")
+    ap.add_argument("--timeout", type=float, default=30.0)
+    args = ap.parse_args()
+
+    try:
+        ok = asyncio.run(run(args))
+    except asyncio.TimeoutError:
+        print(f"timeout {args.timeout:.0f} s")
+        ok = False
+    except (OSError, websockets.exceptions.WebSocketException) as e:
+        print(f"gagal: {e}")
+        ok = False
+
+    print("OK" if ok else "GAGAL")
+    sys.exit(0 if ok else 1)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,444 @@
+/* =========================================================
+ *  LF_SIM: simulator line follower di host
+ *
+ *  Firmware asli (linefollow_task, qtr ISR, pid, motor, odom)
+ *  berjalan di atas shim dengan jam virtual. Model fisik:
+ *  - lintasan oval (2 lurus + 2 setengah lingkaran), garis 19 mm
+ *  - 8 sensor QTR 60 mm di depan poros, waktu discharge dari
+ *    luas garis di bawah sensor
+ *  - roda diferensial, motor orde 1 dengan deadband duty
+ *  - encoder PCNT dari jarak tempuh roda (opsional)
+ *
+ *  Laporan: lap + waktu lap, cross-track error (RMS/max) di titik
+ *  sensor, garis hilang (jumlah + durasi), state akhir.
+ *
+ *  lf_sim [--time s] [--no-encoder] [--csv file]
+ *         [--straight mm] [--radius mm] [--offset mm]
+ *         [--min-laps n] [--max-rms mm] [--max-xte mm] [--max-lost n]
+ *         [--max-speed mm/s]
+ * ========================================================= */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "sim.h"
+#include "nvs.h"
+#include "driver/ledc.h"
+#include "driver/pulse_cnt.h"
+
+#include "motor.h"
+#include "odom.h"
+#include "qtr.h"
+#include "hcsr.h"
+#include "linefollow.h"
+
+// state machine ikut dikompilasi di sini: simulator menjalankan
+// peran robot_state_task (pop event + transisi) tiap tick fisika
+#include "../main/robot_state.c"
+
+/* ===== MODEL ROBOT ===== */
+#define PHYS_DT_S        0.001
+#define WHEEL_BASE_MM    130.0
+#define SENSOR_AHEAD_MM  60.0
+#define SENSOR_PITCH_MM  9.525
+#define TAPE_W_MM        19.0
+#define APERTURE_MM      4.0       // lebar efektif pantulan 1 sensor
+
+/* ===== MODEL MOTOR (duty 13 bit) ===== */
+#define DUTY_FULL        8191
+#define DUTY_STALL       3800      // di bawah ini roda tidak berputar
+#define V_MAX_MM_S       800.0     // duty penuh
+#define TAU_DRIVE_S      0.06
+#define TAU_BRAKE_S      0.02
+#define TAU_COAST_S      0.15
+
+/* ===== MODEL QTR (us discharge) ===== */
+#define WHITE_US         200
+#define BLACK_US         2500
+#define NOISE_US         20
+
+#define COUNTS_PER_MM    (1320.0 / (M_PI * 65.0))
+
+/* pin firmware (motor.c / qtr.c) */
+#define PIN_IN1  15
+#define PIN_IN2  16
+#define PIN_IN3  18
+#define PIN_IN4  19
+
+static const int qtr_pins[QTR_SENSOR_COUNT] = { 38, 39, 1, 2, 3, 4, 5, 6 };
+
+/* ===== OPSI ===== */
+static double sim_time_s   = 30.0;
+static bool   encoders     = true;
+static double straight_mm  = 1000.0;
+static double radius_mm    = 300.0;
+static double offset_mm    = 5.0;
+static int    min_laps     = 0;
+static double max_rms      = 0.0;
+static double max_xte      = 0.0;
+static int    max_lost     = -1;
+static double max_speed    = 0.0;
+static FILE  *csv;
+
+/* ===== STATE FISIK ===== */
+static double x, y, th;            // poros roda, mm / rad
+static double v_wheel[2];          // mm/s
+static double d_wheel[2];          // mm kumulatif
+
+/* ===== STATISTIK ===== */
+static double   progress_mm;
+static double   last_s = -1.0;
+static int      laps;
+static double   lap_start_s;
+static double   lap_times[64];
+static double   xte_sq_sum;
+static double   xte_max;
+static uint32_t xte_n;
+static bool     line_seen = true;
+static int      lost_count;
+static double   lost_time_s;
+static double   dist_mm;
+static int      ticks;
+
+static uint32_t rng = 0x12345678;
+
+static double noise(void)
+{
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return ((int)(rng % 2001) - 1000) / 1000.0;
+}
+
+static double sim_t(void)
+{
+    return sim_now_ns() * 1e-9;
+}
+
+/* =========================================================
+ *  LINTASAN: oval, berlawanan jarum jam, s = 0 di awal lurus bawah
+ * ========================================================= */
+static double track_len(void)
+{
+    return 2.0 * straight_mm + 2.0 * M_PI * radius_mm;
+}
+
+/* jarak titik ke garis tengah, *s = posisi sepanjang lintasan */
+static double track_nearest(double px, double py, double *s)
+{
+    double h = straight_mm / 2.0, r = radius_mm;
+    double best = 1e9, bs = 0.0;
+
+    // lurus bawah (y = -r, x naik) dan atas (y = r, x turun)
+    double cx = px < -h ? -h : (px > h ? h : px);
+    double d  = hypot(px - cx, py + r);
+    if (d < best) { best = d; bs = cx + h; }
+
+    d = hypot(px - cx, py - r);
+    if (d < best) { best = d; bs = straight_mm + M_PI * r + (h - cx); }
+
+    // setengah lingkaran kanan / kiri
+    if (px >= h)
+    {
+        double a = atan2(py, px - h);                      // -pi/2 .. pi/2
+        d = fabs(hypot(px - h, py) - r);
+        if (d < best) { best = d; bs = straight_mm + (a + M_PI / 2) * r; }
+    }
+    if (px <= -h)
+    {
+        double a = atan2(py, px + h);                      // pi/2 .. pi, -pi .. -pi/2
+        if (a < 0) a += 2 * M_PI;
+        d = fabs(hypot(px + h, py) - r);
+        if (d < best) { best = d; bs = 2 * straight_mm + M_PI * r + (a - M_PI / 2) * r; }
+    }
+
+    *s = bs;
+    return best;
+}
+
+/* fraksi aperture sensor yang menutupi garis, 0..1 */
+static double darkness(double dist)
+{
+    double edge = TAPE_W_MM / 2.0;
+    double v = (edge + APERTURE_MM / 2.0 - dist) / APERTURE_MM;
+
+    if (v < 0.0) return 0.0;
+    if (v > 1.0) return 1.0;
+    return v;
+}
+
+/* =========================================================
+ *  SENSOR: waktu discharge tiap pin dari pose saat ini
+ * ========================================================= */
+static bool update_sensors(double *xte)
+{
+    double c = cos(th), sn = sin(th);
+    double bx = x + SENSOR_AHEAD_MM * c;
+    double by = y + SENSOR_AHEAD_MM * sn;
+    double s;
+    bool   any = false;
+
+    *xte = track_nearest(bx, by, &s);
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        // index besar = kiri (error positif -> belok kiri)
+        double lat = (i - (QTR_SENSOR_COUNT - 1) / 2.0) * SENSOR_PITCH_MM;
+        double px  = bx - lat * sn;
+        double py  = by + lat * c;
+        double dk  = darkness(track_nearest(px, py, &s));
+
+        if (dk > 0.05)
+            any = true;
+
+        double us = WHITE_US + (BLACK_US - WHITE_US) * dk + NOISE_US * noise();
+        sim_gpio_set_decay(qtr_pins[i], (int64_t)(us * 1000.0));
+    }
+
+    return any;
+}
+
+/* =========================================================
+ *  MOTOR: duty + arah dari LEDC / GPIO firmware
+ * ========================================================= */
+static void wheel_step(int w, int in_a, int in_b, uint32_t duty)
+{
+    double target = 0.0, tau = TAU_COAST_S;
+
+    if (in_a && in_b)
+    {
+        tau = TAU_BRAKE_S;
+    }
+    else if (in_a || in_b)
+    {
+        tau = TAU_DRIVE_S;
+        if (duty > DUTY_STALL)
+            target = V_MAX_MM_S * (duty - DUTY_STALL) / (DUTY_FULL - DUTY_STALL);
+        if (in_b)
+            target = -target;
+    }
+
+    v_wheel[w] += (target - v_wheel[w]) * PHYS_DT_S / (tau + PHYS_DT_S);
+    d_wheel[w] += v_wheel[w] * PHYS_DT_S;
+
+    if (encoders)
+        sim_pcnt_set(w, (int)lround(d_wheel[w] * COUNTS_PER_MM));
+}
+
+/* peran robot_state_task: terapkan event antrian */
+static void state_pump(void)
+{
+    robot_event_t ev;
+    int arg;
+
+    while (evq_pop(&ev, &arg))
+    {
+        robot_state_t cur  = robot_state_get();
+        robot_state_t next = transition(cur, ev);
+
+        if (next != cur)
+        {
+            atomic_store_explicit(&state, next, memory_order_release);
+            printf("t=%.3f s: %s -> %s (%s)\n", sim_t(),
+                   state_name[cur], state_name[next], event_name[ev]);
+        }
+    }
+}
+
+static void report_and_exit(void *arg);
+
+static void phys_tick(void *arg)
+{
+    wheel_step(MOTOR_LEFT,  sim_gpio_output(PIN_IN1), sim_gpio_output(PIN_IN2),
+               sim_ledc_duty(LEDC_CHANNEL_0));
+    wheel_step(MOTOR_RIGHT, sim_gpio_output(PIN_IN3), sim_gpio_output(PIN_IN4),
+               sim_ledc_duty(LEDC_CHANNEL_1));
+
+    double v = (v_wheel[MOTOR_LEFT] + v_wheel[MOTOR_RIGHT]) / 2.0;
+    double w = (v_wheel[MOTOR_RIGHT] - v_wheel[MOTOR_LEFT]) / WHEEL_BASE_MM;
+
+    x  += v * cos(th) * PHYS_DT_S;
+    y  += v * sin(th) * PHYS_DT_S;
+    th += w * PHYS_DT_S;
+    dist_mm += fabs(v) * PHYS_DT_S;
+
+    double xte;
+    bool seen = update_sensors(&xte);
+
+    // progress sepanjang lintasan -> lap
+    double s, len = track_len();
+    track_nearest(x + SENSOR_AHEAD_MM * cos(th), y + SENSOR_AHEAD_MM * sin(th), &s);
+    if (last_s >= 0.0)
+    {
+        double ds = s - last_s;
+        if (ds < -len / 2) ds += len;
+        if (ds >  len / 2) ds -= len;
+        progress_mm += ds;
+
+        if (progress_mm >= (laps + 1) * len)
+        {
+            if (laps < 64)
+                lap_times[laps] = sim_t() - lap_start_s;
+            lap_start_s = sim_t();
+            laps++;
+        }
+    }
+    last_s = s;
+
+    xte_sq_sum += xte * xte;
+    xte_n++;
+    if (xte > xte_max)
+        xte_max = xte;
+
+    if (!seen)
+        lost_time_s += PHYS_DT_S;
+    if (line_seen && !seen)
+        lost_count++;
+    line_seen = seen;
+
+    if (csv && ticks % 10 == 0)
+        fprintf(csv, "%.3f,%.1f,%.1f,%.4f,%.2f,%.0f,%.0f,%u,%u,%d\n",
+                sim_t(), x, y, th, xte, v_wheel[0], v_wheel[1],
+                (unsigned)sim_ledc_duty(LEDC_CHANNEL_0),
+                (unsigned)sim_ledc_duty(LEDC_CHANNEL_1), robot_state_get());
+    ticks++;
+
+    state_pump();
+
+    if (robot_state_get() == ROBOT_ERROR)
+    {
+        report_and_exit(NULL);
+        return;
+    }
+
+    sim_after((int64_t)(PHYS_DT_S * 1e9), phys_tick, NULL);
+}
+
+/* =========================================================
+ *  LAPORAN
+ * ========================================================= */
+static void report_and_exit(void *arg)
+{
+    double t   = sim_t();
+    double rms = xte_n ? sqrt(xte_sq_sum / xte_n) : 0.0;
+    double spd = t > 0 ? dist_mm / t : 0.0;
+    bool   ok  = true;
+
+    printf("\n== lf_sim %.1f s, encoder %s ==\n", t, encoders ? "ya" : "tidak");
+    printf("lintasan    oval %.0f mm lurus, R %.0f mm (%.0f mm/lap)\n",
+           straight_mm, radius_mm, track_len());
+    printf("lap         %d", laps);
+    for (int i = 0; i < laps && i < 64; i++)
+        printf("%s%.2f", i ? " / " : "  waktu ", lap_times[i]);
+    printf("%s\n", laps ? " s" : "");
+    printf("kecepatan   %.0f mm/s rata-rata\n", spd);
+    printf("cross-track rms %.2f mm, max %.2f mm\n", rms, xte_max);
+    printf("garis hilang %d kali, %.0f ms total\n", lost_count, lost_time_s * 1000.0);
+    printf("state akhir %s\n", state_name[robot_state_get()]);
+
+    linefollow_stats_t st;
+    linefollow_get_stats(&st, false);
+    printf("loop        %lu siklus, periode %lu..%lu us\n",
+           (unsigned long)st.cycles, (unsigned long)st.period_min_us,
+           (unsigned long)st.period_max_us);
+
+    if (robot_state_get() == ROBOT_ERROR)            ok = false;
+    if (laps < min_laps)                             ok = false;
+    if (max_rms > 0.0 && rms > max_rms)              ok = false;
+    if (max_xte > 0.0 && xte_max > max_xte)          ok = false;
+    if (max_lost >= 0 && lost_count > max_lost)      ok = false;
+    if (max_speed > 0.0 && spd > max_speed)          ok = false;
+
+    printf("%s\n", ok ? "OK" : "GAGAL (batas tidak terpenuhi)");
+
+    if (csv)
+        fclose(csv);
+    exit(ok ? 0 : 1);
+}
+
+/* =========================================================
+ *  STUB: tidak ada pot di lintasan
+ * ========================================================= */
+int hcsr_get_distance_cm(void)
+{
+    return -1;
+}
+
+/* kalibrasi tersimpan, sama dengan hasil sapuan di lintasan */
+static void preload_calibration(void)
+{
+    struct {
+        uint16_t min[QTR_SENSOR_COUNT];
+        uint16_t max[QTR_SENSOR_COUNT];
+    } cal;
+    nvs_handle_t nvs;
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        cal.min[i] = WHITE_US;
+        cal.max[i] = BLACK_US;
+    }
+
+    nvs_open("qtr", NVS_READWRITE, &nvs);
+    nvs_set_blob(nvs, "cal", &cal, sizeof(cal));
+    nvs_close(nvs);
+}
+
+static void parse_args(int argc, char **argv)
+{
+    for (int i = 1; i < argc; i++)
+    {
+        const char *a = argv[i];
+        const char *v = i + 1 < argc ? argv[i + 1] : NULL;
+
+        if (!strcmp(a, "--no-encoder"))          { encoders = false; continue; }
+        if (!v)                                  { fprintf(stderr, "argumen %s butuh nilai\n", a); exit(2); }
+
+        if      (!strcmp(a, "--time"))      sim_time_s  = atof(v);
+        else if (!strcmp(a, "--csv"))       csv         = fopen(v, "w");
+        else if (!strcmp(a, "--straight"))  straight_mm = atof(v);
+        else if (!strcmp(a, "--radius"))    radius_mm   = atof(v);
+        else if (!strcmp(a, "--offset"))    offset_mm   = atof(v);
+        else if (!strcmp(a, "--min-laps"))  min_laps    = atoi(v);
+        else if (!strcmp(a, "--max-rms"))   max_rms     = atof(v);
+        else if (!strcmp(a, "--max-xte"))   max_xte     = atof(v);
+        else if (!strcmp(a, "--max-lost"))  max_lost    = atoi(v);
+        else if (!strcmp(a, "--max-speed")) max_speed   = atof(v);
+        else { fprintf(stderr, "argumen tidak dikenal: %s\n", a); exit(2); }
+        i++;
+    }
+
+    if (csv)
+        fprintf(csv, "t,x,y,th,xte,vl,vr,duty_l,duty_r,state\n");
+}
+
+int main(int argc, char **argv)
+{
+    parse_args(argc, argv);
+
+    sim_reset();
+    sim_log_level = 2;
+
+    // awal lurus bawah, sensor di atas garis, sedikit bergeser + miring
+    double h = straight_mm / 2.0;
+    th = 3.0 * M_PI / 180.0;
+    x  = -h + 100.0 - SENSOR_AHEAD_MM * cos(th);
+    y  = -radius_mm + offset_mm - SENSOR_AHEAD_MM * sin(th);
+
+    preload_calibration();
+
+    robot_state_init(ROBOT_RUN);
+    motor_init();
+    odom_init();
+
+    double xte;
+    update_sensors(&xte);
+
+    sim_after((int64_t)(PHYS_DT_S * 1e9), phys_tick, NULL);
+    sim_at((int64_t)(sim_time_s * 1e9), report_and_exit, NULL);
+
+    // tidak kembali: report_and_exit() mengakhiri proses
+    linefollow_task(NULL);
+    return 1;
+}
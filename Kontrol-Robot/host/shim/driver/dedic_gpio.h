@@ -0,0 +1,26 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* ===== SHIM HOST: bundle = snapshot gpio_get_level per pin ===== */
+typedef struct dedic_gpio_bundle_t *dedic_gpio_bundle_handle_t;
+
+typedef struct {
+    const int *gpio_array;
+    size_t     array_size;
+    struct {
+        unsigned int in_en: 1;
+        unsigned int in_invert: 1;
+        unsigned int out_en: 1;
+        unsigned int out_invert: 1;
+    } flags;
+} dedic_gpio_bundle_config_t;
+
+esp_err_t dedic_gpio_new_bundle(const dedic_gpio_bundle_config_t *cfg,
+                                dedic_gpio_bundle_handle_t *ret_bundle);
+esp_err_t dedic_gpio_del_bundle(dedic_gpio_bundle_handle_t bundle);
+uint32_t  dedic_gpio_bundle_read_in(dedic_gpio_bundle_handle_t bundle);
+
+/* host: 1 = dedic_gpio_new_bundle gagal (uji fallback) */
+extern int sim_dedic_fail;
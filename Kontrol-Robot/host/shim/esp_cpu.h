@@ -0,0 +1,7 @@
+#pragma once
+#include <stdint.h>
+
+/* ===== SHIM HOST: cycle counter 240 MHz dari jam virtual ===== */
+typedef uint32_t esp_cpu_cycle_count_t;
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void);
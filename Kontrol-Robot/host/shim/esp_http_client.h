@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/* =========================================================
+ *  SHIM HOST: esp_http_client dengan server tiruan di jam virtual.
+ *  Koneksi TCP dibuka saat perform pertama, dipakai ulang jika
+ *  keep_alive_enable, biaya connect / request memajukan jam.
+ * ========================================================= */
+#define ESP_ERR_HTTP_BASE      0x7000
+#define ESP_ERR_HTTP_CONNECT   (ESP_ERR_HTTP_BASE + 3)
+
+typedef struct esp_http_client *esp_http_client_handle_t;
+
+typedef enum {
+    HTTP_METHOD_GET = 0,
+    HTTP_METHOD_POST,
+    HTTP_METHOD_PUT,
+    HTTP_METHOD_DELETE,
+} esp_http_client_method_t;
+
+typedef struct {
+    const char              *url;
+    esp_http_client_method_t method;
+    int                      timeout_ms;
+    bool                     keep_alive_enable;
+    int                      buffer_size;
+    int                      buffer_size_tx;
+} esp_http_client_config_t;
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *cfg);
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t c, const char *url);
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t c, esp_http_client_method_t m);
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t c, const char *key, const char *value);
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t c, const char *data, int len);
+esp_err_t esp_http_client_perform(esp_http_client_handle_t c);
+int       esp_http_client_get_status_code(esp_http_client_handle_t c);
+esp_err_t esp_http_client_close(esp_http_client_handle_t c);
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t c);
+
+/* ===== sisi test ===== */
+typedef struct {
+    int connect_ms;     // TCP handshake (+ slow start)
+    int request_ms;     // kirim + respons di koneksi terbuka
+    int close_every;    // server menutup keep-alive tiap N request, 0 = tidak
+    int status;         // status HTTP jawaban
+} sim_http_server_t;
+
+void     sim_http_reset(const sim_http_server_t *srv);
+void     sim_http_host_down(const char *host, bool down);
+uint32_t sim_http_connects(void);    // handshake TCP berhasil
+uint32_t sim_http_failures(void);    // perform yang gagal
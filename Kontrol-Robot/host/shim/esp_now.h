@@ -0,0 +1,33 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* ===== SHIM HOST: ESP-NOW, radio = hook test di jam virtual ===== */
+#define ESP_NOW_ETH_ALEN   6
+
+typedef enum {
+    ESP_NOW_SEND_SUCCESS = 0,
+    ESP_NOW_SEND_FAIL,
+} esp_now_send_status_t;
+
+typedef struct {
+    uint8_t *src_addr;
+    uint8_t *des_addr;
+} esp_now_recv_info_t;
+
+typedef void (*esp_now_recv_cb_t)(const esp_now_recv_info_t *info,
+                                  const uint8_t *data, int len);
+typedef void (*esp_now_send_cb_t)(const uint8_t *mac, esp_now_send_status_t status);
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb);
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb);
+esp_err_t esp_now_send(const uint8_t *mac, const uint8_t *data, size_t len);
+
+/* sisi test: frame keluar ke hook, status & frame masuk dijadwalkan di jam */
+typedef void (*sim_espnow_tx_fn_t)(const uint8_t *mac, const uint8_t *data, int len);
+
+void sim_espnow_on_send(sim_espnow_tx_fn_t fn);
+void sim_espnow_status_after(int64_t dt_ns, esp_now_send_status_t status);
+void sim_espnow_recv_after(int64_t dt_ns, const uint8_t *mac,
+                           const uint8_t *data, int len);
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "esp_err.h"
+
+/* =========================================================
+ *  SHIM HOST: satu partisi data di file sementara, semantik NOR:
+ *  write hanya bisa 1 -> 0 (AND), erase per 4 KB mengisi 0xFF.
+ * ========================================================= */
+#define SIM_FLASH_SECTOR   4096
+
+typedef enum {
+    ESP_PARTITION_TYPE_APP  = 0x00,
+    ESP_PARTITION_TYPE_DATA = 0x01,
+} esp_partition_type_t;
+
+typedef enum {
+    ESP_PARTITION_SUBTYPE_DATA_UNDEFINED = 0x06,
+    ESP_PARTITION_SUBTYPE_ANY            = 0xff,
+} esp_partition_subtype_t;
+
+typedef struct {
+    esp_partition_type_t    type;
+    esp_partition_subtype_t subtype;
+    uint32_t                address;
+    uint32_t                size;
+    uint32_t                erase_size;
+    char                    label[17];
+} esp_partition_t;
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label);
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t size);
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t size);
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t size);
+
+/* ===== sisi test ===== */
+/* buat / kosongkan partisi (0xFF), size kelipatan 4 KB; size 0 = tidak ada partisi */
+void     sim_flash_init(const char *label, size_t size);
+/* write berikutnya terpotong setelah keep byte (reset saat program) */
+void     sim_flash_tear_next_write(size_t keep);
+uint32_t sim_flash_erases(void);
+/* write yang mencoba 0 -> 1 (butuh erase), kumulatif; harus 0 */
+uint32_t sim_flash_bad_writes(void);
@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+
+/* ===== SHIM HOST: RNG deterministik, seed dari test ===== */
+uint32_t esp_random(void);
+void     sim_random_seed(uint32_t seed);
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+/* ===== SHIM HOST: CRC32 IEEE (reflected), sama dengan ROM ESP32 ===== */
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len);
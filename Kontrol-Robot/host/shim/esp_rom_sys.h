@@ -0,0 +1,6 @@
+#pragma once
+#include <stdint.h>
+
+/* ===== SHIM HOST ===== */
+void     esp_rom_delay_us(uint32_t us);
+uint32_t esp_rom_get_cpu_ticks_per_us(void);
@@ -0,0 +1,5 @@
+#pragma once
+#include <stdint.h>
+
+/* ===== SHIM HOST: heap dihitung dari alokasi shim (esp_http_client) ===== */
+uint32_t esp_get_free_heap_size(void);
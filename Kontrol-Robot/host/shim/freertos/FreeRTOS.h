@@ -0,0 +1,35 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* ===== SHIM HOST: FreeRTOS di atas jam virtual =====
+ * tick rate runtime (default 1000 Hz); test bisa set sim_tick_hz = 100
+ * seperti sdkconfig default. Blok N tick berakhir di batas tick ke-N. */
+typedef uint32_t TickType_t;
+typedef int      BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE   0
+#define pdTRUE    1
+#define pdFAIL    0
+#define pdPASS    1
+
+extern uint32_t sim_tick_hz;
+
+#define configTICK_RATE_HZ   sim_tick_hz
+#define portTICK_PERIOD_MS   (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY        ((TickType_t)0xffffffffUL)
+#define pdMS_TO_TICKS(ms)    ((TickType_t)((uint64_t)(ms) * configTICK_RATE_HZ / 1000))
+
+typedef struct { int unused; } portMUX_TYPE;
+#define portMUX_INITIALIZER_UNLOCKED   { 0 }
+
+// satu "CPU": critical section tidak perlu lock
+#define portENTER_CRITICAL(m)       ((void)(m))
+#define portEXIT_CRITICAL(m)        ((void)(m))
+#define portENTER_CRITICAL_ISR(m)   ((void)(m))
+#define portEXIT_CRITICAL_ISR(m)    ((void)(m))
+#define portYIELD_FROM_ISR(w)       ((void)(w))
+
+#define configASSERT(x) do { if (!(x)) __builtin_trap(); } while (0)
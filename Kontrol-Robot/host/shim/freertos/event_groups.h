@@ -0,0 +1,11 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+/* ===== SHIM HOST: hanya tipe (conn.h) ===== */
+typedef struct sim_event_group *EventGroupHandle_t;
+typedef uint32_t                EventBits_t;
+
+#define BIT0   (1u << 0)
+#define BIT1   (1u << 1)
+#define BIT2   (1u << 2)
+#define BIT3   (1u << 3)
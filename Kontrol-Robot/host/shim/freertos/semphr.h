@@ -0,0 +1,14 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+/* semaphore = queue item 0 byte, seperti FreeRTOS */
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+
+#define xSemaphoreTake(s, t)            xQueueReceive(s, NULL, t)
+#define xSemaphoreGive(s)               xQueueSend(s, NULL, 0)
+#define xSemaphoreGiveFromISR(s, w)     xQueueSendFromISR(s, NULL, w)
+#define vSemaphoreDelete(s)             vQueueDelete(s)
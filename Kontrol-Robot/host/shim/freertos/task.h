@@ -0,0 +1,26 @@
+#pragma once
+#include "freertos/FreeRTOS.h"
+
+typedef struct sim_task *TaskHandle_t;
+
+typedef enum {
+    eNoAction = 0,
+    eSetBits,
+    eIncrement,
+    eSetValueWithOverwrite,
+    eSetValueWithoutOverwrite,
+} eNotifyAction;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+TickType_t   xTaskGetTickCount(void);
+void         vTaskDelay(TickType_t ticks);
+
+BaseType_t   xTaskNotifyGive(TaskHandle_t task);
+void         vTaskNotifyGiveFromISR(TaskHandle_t task, BaseType_t *woken);
+uint32_t     ulTaskNotifyTake(BaseType_t clear, TickType_t ticks);
+BaseType_t   xTaskNotify(TaskHandle_t task, uint32_t value, eNotifyAction action);
+BaseType_t   xTaskNotifyFromISR(TaskHandle_t task, uint32_t value,
+                                eNotifyAction action, BaseType_t *woken);
+BaseType_t   xTaskNotifyWait(uint32_t clear_entry, uint32_t clear_exit,
+                             uint32_t *value, TickType_t ticks);
+BaseType_t   xTaskNotifyStateClear(TaskHandle_t task);
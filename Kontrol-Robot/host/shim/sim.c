@@ -0,0 +1,189 @@
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stdint.h>
+
+#include "esp_err.h"
+
+/* ===== ANTRIAN EVENT ===== */
+#define SIM_MAX_EVENTS 256
+
+typedef struct {
+    int64_t  t_ns;
+    uint32_t order;     // FIFO untuk waktu yang sama
+    int      id;
+    sim_fn_t fn;
+    void    *arg;
+} sim_event_t;
+
+static sim_event_t events[SIM_MAX_EVENTS];
+static int         n_events;
+static int64_t     now_ns;
+static uint32_t    next_order;
+static int         next_id = 1;
+
+int sim_log_level = 2;
+
+static int failures;
+
+// ==========================================
+void sim_reset(void)
+{
+    n_events   = 0;
+    now_ns     = 0;
+    next_order = 0;
+}
+
+int64_t sim_now_ns(void)
+{
+    return now_ns;
+}
+
+/* biaya eksekusi (baca register, loop): jam maju tanpa menjalankan event */
+void sim_cost(int64_t dt_ns)
+{
+    now_ns += dt_ns;
+}
+
+int sim_at(int64_t t_ns, sim_fn_t fn, void *arg)
+{
+    if (n_events >= SIM_MAX_EVENTS)
+    {
+        fprintf(stderr, "sim: antrian event penuh\n");
+        return 0;
+    }
+
+    sim_event_t *e = &events[n_events++];
+    e->t_ns  = t_ns < now_ns ? now_ns : t_ns;
+    e->order = next_order++;
+    e->id    = next_id++;
+    e->fn    = fn;
+    e->arg   = arg;
+    return e->id;
+}
+
+int sim_after(int64_t dt_ns, sim_fn_t fn, void *arg)
+{
+    return sim_at(now_ns + dt_ns, fn, arg);
+}
+
+void sim_cancel(int id)
+{
+    for (int i = 0; i < n_events; i++)
+    {
+        if (events[i].id == id)
+        {
+            events[i] = events[--n_events];
+            return;
+        }
+    }
+}
+
+/* event paling awal dengan t <= limit, -1 = tidak ada */
+static int sim_next(int64_t limit)
+{
+    int best = -1;
+
+    for (int i = 0; i < n_events; i++)
+    {
+        if (events[i].t_ns > limit)
+            continue;
+        if (best < 0 ||
+            events[i].t_ns < events[best].t_ns ||
+            (events[i].t_ns == events[best].t_ns &&
+             events[i].order < events[best].order))
+            best = i;
+    }
+    return best;
+}
+
+static void sim_pop_run(int i)
+{
+    sim_event_t e = events[i];
+    events[i] = events[--n_events];
+
+    if (e.t_ns > now_ns)
+        now_ns = e.t_ns;
+    e.fn(e.arg);
+}
+
+void sim_run_until(int64_t t_ns)
+{
+    int i;
+    while ((i = sim_next(t_ns)) >= 0)
+        sim_pop_run(i);
+
+    if (t_ns > now_ns)
+        now_ns = t_ns;
+}
+
+void sim_advance(int64_t dt_ns)
+{
+    sim_run_until(now_ns + dt_ns);
+}
+
+bool sim_wait(bool (*cond)(void *), void *ctx, int64_t deadline_ns)
+{
+    while (!cond(ctx))
+    {
+        int i = sim_next(deadline_ns);
+        if (i < 0)
+        {
+            // tanpa event lagi: portMAX_DELAY = deadlock, jam tidak dilompati
+            if (deadline_ns != INT64_MAX && deadline_ns > now_ns)
+                now_ns = deadline_ns;
+            return cond(ctx);
+        }
+        sim_pop_run(i);
+    }
+    return true;
+}
+
+/* ===== LOG ===== */
+void sim_log(int level, const char *tag, const char *fmt, ...)
+{
+    static const char lv[] = "?EWIDV";
+    va_list ap;
+
+    if (level > sim_log_level)
+        return;
+
+    printf("%c (%lld) %s: ", lv[level < 6 ? level : 0],
+           (long long)(now_ns / 1000000), tag);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+}
+
+const char *esp_err_to_name(esp_err_t err)
+{
+    switch (err)
+    {
+        case ESP_OK:                return "ESP_OK";
+        case ESP_FAIL:              return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:        return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:   return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE: return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:  return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:     return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_TIMEOUT:       return "ESP_ERR_TIMEOUT";
+        default:                    return "ESP_ERR_?";
+    }
+}
+
+/* ===== CEK ===== */
+void sim_check(bool ok, const char *expr, const char *file, int line)
+{
+    if (ok)
+        return;
+
+    failures++;
+    printf("GAGAL %s:%d: %s\n", file, line, expr);
+}
+
+int sim_failures(void)
+{
+    return failures;
+}
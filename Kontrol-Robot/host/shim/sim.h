@@ -0,0 +1,54 @@
+#ifndef SIM_H
+#define SIM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* =========================================================
+ *  SIMULASI HOST: jam virtual (ns) + antrian event.
+ *  Semua "blocking" di shim FreeRTOS / ROM memajukan jam ini
+ *  dan menjalankan event (ISR, esp_timer, peer tiruan) sesuai urutan.
+ * ========================================================= */
+
+typedef void (*sim_fn_t)(void *arg);
+
+void     sim_reset(void);
+int64_t  sim_now_ns(void);
+
+/* event sekali jalan pada waktu absolut; return id untuk sim_cancel */
+int      sim_at(int64_t t_ns, sim_fn_t fn, void *arg);
+int      sim_after(int64_t dt_ns, sim_fn_t fn, void *arg);
+void     sim_cancel(int id);
+
+/* jalankan event sampai t_ns (jam = t_ns di akhir) */
+void     sim_run_until(int64_t t_ns);
+void     sim_advance(int64_t dt_ns);
+
+/* biaya eksekusi (baca register, loop sibuk): jam maju tanpa event */
+void     sim_cost(int64_t dt_ns);
+
+/* jalankan event sampai cond(ctx) true atau deadline. true = cond terpenuhi */
+bool     sim_wait(bool (*cond)(void *), void *ctx, int64_t deadline_ns);
+
+/* ===== GPIO ===== */
+/* waktu discharge RC setelah pin high -> input, -1 = tidak pernah turun */
+void     sim_gpio_set_decay(int pin, int64_t decay_ns);
+/* level dari luar (sensor), memicu ISR jika edge cocok */
+void     sim_gpio_drive(int pin, int level);
+/* hook saat output pin berubah (mis. TRIG HC-SR04) */
+void     sim_gpio_on_output(int pin, void (*fn)(int pin, int level));
+int      sim_gpio_output(int pin);
+/* jumlah panggilan gpio_get_level (deteksi spin) */
+uint32_t sim_gpio_reads(void);
+/* jumlah dedic_gpio_bundle_read_in, bundle yang masih dialokasikan */
+uint32_t sim_dedic_reads(void);
+int      sim_dedic_bundles(void);
+
+/* ===== LOG ===== */
+extern int sim_log_level;   // 0 = diam, 1 = E, 2 = W, 3 = I
+
+#define SIM_CHECK(c) sim_check((c), #c, __FILE__, __LINE__)
+void     sim_check(bool ok, const char *expr, const char *file, int line);
+int      sim_failures(void);
+
+#endif
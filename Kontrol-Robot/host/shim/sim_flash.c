@@ -0,0 +1,149 @@
+#include "sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_partition.h"
+#include "esp_rom/crc.h"
+
+/* =========================================================
+ *  FLASH (esp_partition)
+ *  Isi partisi di tmpfile: tetap ada antar journal_init()
+ *  ("reboot") selama proses test hidup.
+ * ========================================================= */
+static FILE           *flash_file;
+static esp_partition_t flash_part;
+static bool            flash_present;
+static long            flash_tear = -1;    // -1 = tidak ada
+static uint32_t        flash_erases;
+static uint32_t        flash_bad_writes;
+
+void sim_flash_init(const char *label, size_t size)
+{
+    if (flash_file)
+        fclose(flash_file);
+    flash_file    = NULL;
+    flash_present = size > 0;
+    flash_tear    = -1;
+    flash_erases  = 0;
+
+    if (!flash_present)
+        return;
+
+    if (size % SIM_FLASH_SECTOR)
+        abort();
+
+    flash_file = tmpfile();
+    if (!flash_file)
+        abort();
+
+    uint8_t blank[SIM_FLASH_SECTOR];
+    memset(blank, 0xFF, sizeof(blank));
+    for (size_t off = 0; off < size; off += sizeof(blank))
+        fwrite(blank, 1, sizeof(blank), flash_file);
+    fflush(flash_file);
+
+    memset(&flash_part, 0, sizeof(flash_part));
+    flash_part.type       = ESP_PARTITION_TYPE_DATA;
+    flash_part.subtype    = ESP_PARTITION_SUBTYPE_DATA_UNDEFINED;
+    flash_part.size       = (uint32_t)size;
+    flash_part.erase_size = SIM_FLASH_SECTOR;
+    strncpy(flash_part.label, label, sizeof(flash_part.label) - 1);
+}
+
+void     sim_flash_tear_next_write(size_t keep) { flash_tear = (long)keep; }
+uint32_t sim_flash_erases(void)                 { return flash_erases; }
+uint32_t sim_flash_bad_writes(void)             { return flash_bad_writes; }
+
+const esp_partition_t *esp_partition_find_first(esp_partition_type_t type,
+                                                esp_partition_subtype_t subtype,
+                                                const char *label)
+{
+    if (!flash_present || type != flash_part.type)
+        return NULL;
+    if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != flash_part.subtype)
+        return NULL;
+    if (label && strcmp(label, flash_part.label) != 0)
+        return NULL;
+    return &flash_part;
+}
+
+static bool range_ok(const esp_partition_t *p, size_t offset, size_t size)
+{
+    return p == &flash_part && offset <= p->size && size <= p->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t *p, size_t offset, void *dst, size_t size)
+{
+    if (!range_ok(p, offset, size))
+        return ESP_ERR_INVALID_ARG;
+
+    fseek(flash_file, (long)offset, SEEK_SET);
+    return fread(dst, 1, size, flash_file) == size ? ESP_OK : ESP_FAIL;
+}
+
+/* NOR: bit hanya bisa turun */
+esp_err_t esp_partition_write(const esp_partition_t *p, size_t offset, const void *src, size_t size)
+{
+    if (!range_ok(p, offset, size))
+        return ESP_ERR_INVALID_ARG;
+
+    if (flash_tear >= 0 && (size_t)flash_tear < size)
+    {
+        size = (size_t)flash_tear;
+        flash_tear = -1;
+    }
+
+    const uint8_t *in = src;
+    for (size_t i = 0; i < size; i++)
+    {
+        uint8_t cur;
+
+        fseek(flash_file, (long)(offset + i), SEEK_SET);
+        if (fread(&cur, 1, 1, flash_file) != 1)
+            return ESP_FAIL;
+
+        if (in[i] & ~cur)
+            flash_bad_writes++;
+
+        cur &= in[i];
+        fseek(flash_file, (long)(offset + i), SEEK_SET);
+        fwrite(&cur, 1, 1, flash_file);
+    }
+    fflush(flash_file);
+    return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t *p, size_t offset, size_t size)
+{
+    if (!range_ok(p, offset, size) ||
+        offset % SIM_FLASH_SECTOR || size % SIM_FLASH_SECTOR)
+        return ESP_ERR_INVALID_ARG;
+
+    uint8_t blank[SIM_FLASH_SECTOR];
+    memset(blank, 0xFF, sizeof(blank));
+
+    fseek(flash_file, (long)offset, SEEK_SET);
+    for (size_t off = 0; off < size; off += sizeof(blank))
+        fwrite(blank, 1, sizeof(blank), flash_file);
+    fflush(flash_file);
+
+    flash_erases += size / SIM_FLASH_SECTOR;
+    return ESP_OK;
+}
+
+/* =========================================================
+ *  CRC32 (esp_rom/crc.h)
+ * ========================================================= */
+uint32_t esp_rom_crc32_le(uint32_t crc, const uint8_t *buf, uint32_t len)
+{
+    crc = ~crc;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        crc ^= buf[i];
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1));
+    }
+    return ~crc;
+}
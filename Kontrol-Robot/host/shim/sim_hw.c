@@ -0,0 +1,530 @@
+#include "sim.h"
+
+#include <stdlib.h>
+
+#include "driver/gpio.h"
+#include "driver/dedic_gpio.h"
+#include "driver/ledc.h"
+#include "driver/pulse_cnt.h"
+#include "esp_timer.h"
+#include "esp_rom_sys.h"
+#include "esp_cpu.h"
+#include "esp_random.h"
+
+#define CPU_MHZ         240
+#define GPIO_READ_NS    50      // biaya 1x gpio_get_level (APB)
+#define DEDIC_READ_NS   10      // biaya 1x baca bundle
+#define CYCLE_READ_NS   10      // biaya 1x baca cycle counter
+
+/* =========================================================
+ *  GPIO
+ *  Pin input setelah di-drive high turun sendiri setelah decay_ns
+ *  (kapasitor QTR), selain itu level = ext_level dari test.
+ * ========================================================= */
+typedef struct {
+    gpio_mode_t     mode;
+    int             out_level;
+    int             ext_level;
+
+    bool            has_decay;
+    int64_t         decay_ns;
+    bool            decaying;
+    int64_t         release_ns;
+    int             fall_ev;
+
+    gpio_int_type_t intr_type;
+    bool            intr_en;
+    gpio_isr_t      isr;
+    void           *isr_arg;
+
+    void          (*on_output)(int pin, int level);
+} sim_pin_t;
+
+static sim_pin_t pins[GPIO_NUM_MAX];
+static bool      isr_service;
+static uint32_t  n_reads;
+
+static sim_pin_t *pin_get(int pin)
+{
+    if (pin < 0 || pin >= GPIO_NUM_MAX)
+        abort();
+    return &pins[pin];
+}
+
+static int pin_level(sim_pin_t *p)
+{
+    if (p->mode == GPIO_MODE_OUTPUT)
+        return p->out_level;
+
+    if (p->decaying)
+    {
+        if (p->decay_ns < 0)
+            return 1;
+        return sim_now_ns() < p->release_ns + p->decay_ns;
+    }
+
+    return p->ext_level;
+}
+
+static void pin_edge(sim_pin_t *p, int from, int to)
+{
+    if (from == to || !p->intr_en || !p->isr)
+        return;
+
+    bool fire = (p->intr_type == GPIO_INTR_ANYEDGE) ||
+                (p->intr_type == GPIO_INTR_NEGEDGE && to == 0) ||
+                (p->intr_type == GPIO_INTR_POSEDGE && to == 1);
+
+    if (fire)
+        p->isr(p->isr_arg);
+}
+
+static void pin_fall_cb(void *arg)
+{
+    sim_pin_t *p = arg;
+
+    p->fall_ev   = 0;
+    p->decaying  = false;
+    p->ext_level = 0;
+    pin_edge(p, 1, 0);
+}
+
+static void pin_stop_decay(sim_pin_t *p)
+{
+    if (p->fall_ev)
+        sim_cancel(p->fall_ev);
+    p->fall_ev  = 0;
+    p->decaying = false;
+}
+
+void sim_gpio_set_decay(int pin, int64_t decay_ns)
+{
+    sim_pin_t *p = pin_get(pin);
+    p->has_decay = true;
+    p->decay_ns  = decay_ns;
+}
+
+void sim_gpio_drive(int pin, int level)
+{
+    sim_pin_t *p = pin_get(pin);
+    int from = pin_level(p);
+
+    pin_stop_decay(p);
+    p->ext_level = level;
+
+    if (p->mode != GPIO_MODE_OUTPUT)
+        pin_edge(p, from, level);
+}
+
+void sim_gpio_on_output(int pin, void (*fn)(int pin, int level))
+{
+    pin_get(pin)->on_output = fn;
+}
+
+int sim_gpio_output(int pin)
+{
+    return pin_get(pin)->out_level;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t pin)
+{
+    sim_pin_t *p = pin_get(pin);
+
+    pin_stop_decay(p);
+    p->mode      = GPIO_MODE_DISABLE;
+    p->out_level = 0;
+    p->intr_type = GPIO_INTR_DISABLE;
+    p->intr_en   = false;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t pin, gpio_mode_t mode)
+{
+    sim_pin_t *p = pin_get(pin);
+
+    if (mode == GPIO_MODE_INPUT && p->mode == GPIO_MODE_OUTPUT &&
+        p->out_level && p->has_decay)
+    {
+        // kapasitor penuh, mulai discharge
+        p->mode       = mode;
+        p->decaying   = true;
+        p->release_ns = sim_now_ns();
+        p->ext_level  = 1;
+        if (p->decay_ns >= 0)
+            p->fall_ev = sim_after(p->decay_ns, pin_fall_cb, p);
+        return ESP_OK;
+    }
+
+    if (mode == GPIO_MODE_OUTPUT)
+        pin_stop_decay(p);
+
+    p->mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t pin, uint32_t level)
+{
+    sim_pin_t *p = pin_get(pin);
+    int lv = level ? 1 : 0;
+
+    if (lv == p->out_level)
+        return ESP_OK;
+
+    p->out_level = lv;
+    if (p->on_output)
+        p->on_output(pin, lv);
+    return ESP_OK;
+}
+
+uint32_t sim_gpio_reads(void)
+{
+    return n_reads;
+}
+
+int gpio_get_level(gpio_num_t pin)
+{
+    n_reads++;
+    sim_cost(GPIO_READ_NS);
+    return pin_level(pin_get(pin));
+}
+
+esp_err_t gpio_config(const gpio_config_t *cfg)
+{
+    for (int i = 0; i < GPIO_NUM_MAX; i++)
+    {
+        if (!(cfg->pin_bit_mask & (1ULL << i)))
+            continue;
+
+        gpio_set_direction(i, cfg->mode);
+        pins[i].intr_type = cfg->intr_type;
+        pins[i].intr_en   = cfg->intr_type != GPIO_INTR_DISABLE;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_install_isr_service(int flags)
+{
+    (void)flags;
+    if (isr_service)
+        return ESP_ERR_INVALID_STATE;
+    isr_service = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_add(gpio_num_t pin, gpio_isr_t isr, void *arg)
+{
+    if (!isr_service)
+        return ESP_ERR_INVALID_STATE;
+
+    sim_pin_t *p = pin_get(pin);
+    p->isr     = isr;
+    p->isr_arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t gpio_isr_handler_remove(gpio_num_t pin)
+{
+    pin_get(pin)->isr = NULL;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_intr_type(gpio_num_t pin, gpio_int_type_t type)
+{
+    pin_get(pin)->intr_type = type;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_enable(gpio_num_t pin)
+{
+    pin_get(pin)->intr_en = true;
+    return ESP_OK;
+}
+
+esp_err_t gpio_intr_disable(gpio_num_t pin)
+{
+    pin_get(pin)->intr_en = false;
+    return ESP_OK;
+}
+
+/* =========================================================
+ *  DEDICATED GPIO (input bundle)
+ * ========================================================= */
+struct dedic_gpio_bundle_t {
+    int    pins[32];
+    size_t n;
+};
+
+int sim_dedic_fail = 0;
+
+static uint32_t dedic_reads;
+static int      dedic_live;
+
+uint32_t sim_dedic_reads(void)
+{
+    return dedic_reads;
+}
+
+int sim_dedic_bundles(void)
+{
+    return dedic_live;
+}
+
+esp_err_t dedic_gpio_new_bundle(const dedic_gpio_bundle_config_t *cfg,
+                                dedic_gpio_bundle_handle_t *ret_bundle)
+{
+    if (sim_dedic_fail || cfg->array_size > 32)
+        return ESP_FAIL;
+
+    struct dedic_gpio_bundle_t *b = calloc(1, sizeof(*b));
+    for (size_t i = 0; i < cfg->array_size; i++)
+        b->pins[i] = cfg->gpio_array[i];
+    b->n = cfg->array_size;
+    dedic_live++;
+
+    *ret_bundle = b;
+    return ESP_OK;
+}
+
+esp_err_t dedic_gpio_del_bundle(dedic_gpio_bundle_handle_t bundle)
+{
+    free(bundle);
+    dedic_live--;
+    return ESP_OK;
+}
+
+uint32_t dedic_gpio_bundle_read_in(dedic_gpio_bundle_handle_t bundle)
+{
+    uint32_t v = 0;
+
+    dedic_reads++;
+    sim_cost(DEDIC_READ_NS);
+    for (size_t i = 0; i < bundle->n; i++)
+        v |= (uint32_t)pin_level(pin_get(bundle->pins[i])) << i;
+    return v;
+}
+
+/* =========================================================
+ *  ESP_TIMER
+ * ========================================================= */
+struct esp_timer {
+    esp_timer_cb_t cb;
+    void          *arg;
+    int64_t        period_ns;   // 0 = one-shot
+    int            ev;
+};
+
+static void timer_fire(void *arg)
+{
+    struct esp_timer *t = arg;
+
+    t->ev = 0;
+    if (t->period_ns)
+        t->ev = sim_after(t->period_ns, timer_fire, t);
+
+    t->cb(t->arg);
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return sim_now_ns() / 1000;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *args,
+                           esp_timer_handle_t *out)
+{
+    struct esp_timer *t = calloc(1, sizeof(*t));
+    t->cb  = args->callback;
+    t->arg = args->arg;
+    *out = t;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeout_us)
+{
+    if (t->ev)
+        return ESP_ERR_INVALID_STATE;
+
+    t->period_ns = 0;
+    t->ev = sim_after((int64_t)timeout_us * 1000, timer_fire, t);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t period_us)
+{
+    if (t->ev)
+        return ESP_ERR_INVALID_STATE;
+
+    t->period_ns = (int64_t)period_us * 1000;
+    t->ev = sim_after(t->period_ns, timer_fire, t);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t)
+{
+    if (!t->ev)
+        return ESP_ERR_INVALID_STATE;
+
+    sim_cancel(t->ev);
+    t->ev = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t t)
+{
+    if (t->ev)
+        return ESP_ERR_INVALID_STATE;
+    free(t);
+    return ESP_OK;
+}
+
+/* =========================================================
+ *  ROM / CPU
+ * ========================================================= */
+void esp_rom_delay_us(uint32_t us)
+{
+    sim_advance((int64_t)us * 1000);
+}
+
+uint32_t esp_rom_get_cpu_ticks_per_us(void)
+{
+    return CPU_MHZ;
+}
+
+esp_cpu_cycle_count_t esp_cpu_get_cycle_count(void)
+{
+    sim_cost(CYCLE_READ_NS);
+    return (uint32_t)(sim_now_ns() * CPU_MHZ / 1000);
+}
+
+/* xorshift32: deterministik per seed, seed 0 tidak dipakai */
+static uint32_t rng_state = 0x12345678u;
+
+void sim_random_seed(uint32_t seed)
+{
+    rng_state = seed ? seed : 0x12345678u;
+}
+
+uint32_t esp_random(void)
+{
+    rng_state ^= rng_state << 13;
+    rng_state ^= rng_state >> 17;
+    rng_state ^= rng_state << 5;
+    return rng_state;
+}
+
+/* =========================================================
+ *  LEDC
+ * ========================================================= */
+static uint32_t ledc_pending[LEDC_CHANNEL_MAX];
+static uint32_t ledc_duty[LEDC_CHANNEL_MAX];
+
+esp_err_t ledc_timer_config(const ledc_timer_config_t *cfg)
+{
+    return ESP_OK;
+}
+
+esp_err_t ledc_channel_config(const ledc_channel_config_t *cfg)
+{
+    ledc_pending[cfg->channel] = cfg->duty;
+    ledc_duty[cfg->channel]    = cfg->duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t ch, uint32_t duty)
+{
+    ledc_pending[ch] = duty;
+    return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t ch)
+{
+    ledc_duty[ch] = ledc_pending[ch];
+    return ESP_OK;
+}
+
+uint32_t sim_ledc_duty(ledc_channel_t ch)
+{
+    return ledc_duty[ch];
+}
+
+/* =========================================================
+ *  PCNT
+ * ========================================================= */
+#define PCNT_UNITS 4
+
+struct pcnt_unit_t {
+    int  count;
+    int  offset;    // clear_count
+};
+
+static struct pcnt_unit_t pcnt_units[PCNT_UNITS];
+static int                n_pcnt;
+
+esp_err_t pcnt_new_unit(const pcnt_unit_config_t *cfg, pcnt_unit_handle_t *ret)
+{
+    if (n_pcnt >= PCNT_UNITS)
+        return ESP_ERR_NOT_FOUND;
+
+    *ret = &pcnt_units[n_pcnt++];
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_set_glitch_filter(pcnt_unit_handle_t unit,
+                                      const pcnt_glitch_filter_config_t *cfg)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_new_channel(pcnt_unit_handle_t unit, const pcnt_chan_config_t *cfg,
+                           pcnt_channel_handle_t *ret)
+{
+    *ret = (pcnt_channel_handle_t)unit;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_edge_action(pcnt_channel_handle_t ch,
+                                       pcnt_channel_edge_action_t pos,
+                                       pcnt_channel_edge_action_t neg)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_channel_set_level_action(pcnt_channel_handle_t ch,
+                                        pcnt_channel_level_action_t high,
+                                        pcnt_channel_level_action_t low)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_add_watch_point(pcnt_unit_handle_t unit, int point)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_enable(pcnt_unit_handle_t unit)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_clear_count(pcnt_unit_handle_t unit)
+{
+    unit->offset = unit->count;
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_start(pcnt_unit_handle_t unit)
+{
+    return ESP_OK;
+}
+
+esp_err_t pcnt_unit_get_count(pcnt_unit_handle_t unit, int *value)
+{
+    *value = unit->count - unit->offset;
+    return ESP_OK;
+}
+
+void sim_pcnt_set(int unit, int count)
+{
+    if (unit >= 0 && unit < PCNT_UNITS)
+        pcnt_units[unit].count = count;
+}
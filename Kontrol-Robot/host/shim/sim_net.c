@@ -0,0 +1,323 @@
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "esp_now.h"
+#include "esp_http_client.h"
+#include "esp_system.h"
+
+/* =========================================================
+ *  ESP-NOW
+ *  esp_now_send() -> hook test (peer tiruan), status kirim dan
+ *  frame balasan dijadwalkan sebagai event di jam virtual.
+ * ========================================================= */
+#define NOW_MAX_PENDING  16
+#define NOW_MAX_LEN      250
+
+typedef struct {
+    bool                  used;
+    bool                  is_status;
+    esp_now_send_status_t status;
+    uint8_t               mac[ESP_NOW_ETH_ALEN];
+    uint8_t               data[NOW_MAX_LEN];
+    int                   len;
+} now_pkt_t;
+
+static esp_now_recv_cb_t  now_recv_cb;
+static esp_now_send_cb_t  now_send_cb;
+static sim_espnow_tx_fn_t now_tx_hook;
+static now_pkt_t          now_pkts[NOW_MAX_PENDING];
+
+esp_err_t esp_now_register_recv_cb(esp_now_recv_cb_t cb)
+{
+    now_recv_cb = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_register_send_cb(esp_now_send_cb_t cb)
+{
+    now_send_cb = cb;
+    return ESP_OK;
+}
+
+esp_err_t esp_now_send(const uint8_t *mac, const uint8_t *data, size_t len)
+{
+    if (len > NOW_MAX_LEN)
+        return ESP_ERR_INVALID_ARG;
+
+    if (now_tx_hook)
+        now_tx_hook(mac, data, (int)len);
+    return ESP_OK;
+}
+
+void sim_espnow_on_send(sim_espnow_tx_fn_t fn)
+{
+    now_tx_hook = fn;
+}
+
+static now_pkt_t *pkt_alloc(void)
+{
+    for (int i = 0; i < NOW_MAX_PENDING; i++)
+    {
+        if (!now_pkts[i].used)
+        {
+            now_pkts[i].used = true;
+            return &now_pkts[i];
+        }
+    }
+    abort();
+}
+
+static void pkt_deliver(void *arg)
+{
+    now_pkt_t *p = arg;
+
+    p->used = false;
+
+    if (p->is_status)
+    {
+        if (now_send_cb)
+            now_send_cb(p->mac, p->status);
+        return;
+    }
+
+    if (now_recv_cb)
+    {
+        esp_now_recv_info_t info = { .src_addr = p->mac, .des_addr = NULL };
+        now_recv_cb(&info, p->data, p->len);
+    }
+}
+
+void sim_espnow_status_after(int64_t dt_ns, esp_now_send_status_t status)
+{
+    now_pkt_t *p = pkt_alloc();
+
+    p->is_status = true;
+    p->status    = status;
+    memset(p->mac, 0, sizeof(p->mac));
+    sim_after(dt_ns, pkt_deliver, p);
+}
+
+void sim_espnow_recv_after(int64_t dt_ns, const uint8_t *mac,
+                           const uint8_t *data, int len)
+{
+    if (len > NOW_MAX_LEN)
+        abort();
+
+    now_pkt_t *p = pkt_alloc();
+
+    p->is_status = false;
+    p->len       = len;
+    memcpy(p->mac, mac, ESP_NOW_ETH_ALEN);
+    memcpy(p->data, data, len);
+    sim_after(dt_ns, pkt_deliver, p);
+}
+
+/* =========================================================
+ *  HEAP
+ *  Hanya alokasi yang dimodelkan shim (client HTTP + socket).
+ * ========================================================= */
+#define HEAP_TOTAL        (300 * 1024)
+#define HTTP_CLIENT_BYTES 600     // struct + header default
+#define HTTP_SOCKET_BYTES 1600    // pcb lwIP + buffer socket
+
+static uint32_t heap_used;
+
+uint32_t esp_get_free_heap_size(void)
+{
+    return HEAP_TOTAL - heap_used;
+}
+
+/* =========================================================
+ *  ESP_HTTP_CLIENT
+ *  Server tiruan: connect_ms per handshake, request_ms per request.
+ *  Koneksi keep-alive ditutup server tiap close_every request;
+ *  request berikutnya di koneksi itu gagal (RST) tanpa timeout.
+ * ========================================================= */
+#define HTTP_HOST_LEN   64
+#define HTTP_MAX_DOWN   4
+
+struct esp_http_client {
+    char     host[HTTP_HOST_LEN];
+    bool     keep_alive;
+    int      timeout_ms;
+    int      bytes;
+    bool     connected;
+    int      conn_requests;   // request di koneksi ini
+    int      status;
+};
+
+static sim_http_server_t http_srv = { .connect_ms = 30, .request_ms = 15, .status = 200 };
+static char              http_down[HTTP_MAX_DOWN][HTTP_HOST_LEN];
+static uint32_t          http_connects;
+static uint32_t          http_failures;
+
+void sim_http_reset(const sim_http_server_t *srv)
+{
+    http_srv      = *srv;
+    http_connects = 0;
+    http_failures = 0;
+    memset(http_down, 0, sizeof(http_down));
+}
+
+uint32_t sim_http_connects(void) { return http_connects; }
+uint32_t sim_http_failures(void) { return http_failures; }
+
+/* "http://host:port/path" -> "host:port" */
+static void url_host(const char *url, char *out)
+{
+    const char *p = strstr(url, "://");
+    p = p ? p + 3 : url;
+
+    int n = 0;
+    while (p[n] && p[n] != '/' && n < HTTP_HOST_LEN - 1)
+    {
+        out[n] = p[n];
+        n++;
+    }
+    out[n] = 0;
+}
+
+void sim_http_host_down(const char *host, bool down)
+{
+    int free_i = -1;
+
+    for (int i = 0; i < HTTP_MAX_DOWN; i++)
+    {
+        if (strcmp(http_down[i], host) == 0)
+        {
+            if (!down)
+                http_down[i][0] = 0;
+            return;
+        }
+        if (http_down[i][0] == 0 && free_i < 0)
+            free_i = i;
+    }
+
+    if (down && free_i >= 0)
+        strncpy(http_down[free_i], host, HTTP_HOST_LEN - 1);
+}
+
+static bool host_is_down(const char *host)
+{
+    for (int i = 0; i < HTTP_MAX_DOWN; i++)
+        if (http_down[i][0] && strcmp(http_down[i], host) == 0)
+            return true;
+    return false;
+}
+
+static void http_disconnect(esp_http_client_handle_t c)
+{
+    if (!c->connected)
+        return;
+
+    c->connected     = false;
+    c->conn_requests = 0;
+    heap_used       -= HTTP_SOCKET_BYTES;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *cfg)
+{
+    esp_http_client_handle_t c = calloc(1, sizeof(*c));
+    if (!c)
+        abort();
+
+    url_host(cfg->url, c->host);
+    c->keep_alive = cfg->keep_alive_enable;
+    c->timeout_ms = cfg->timeout_ms ? cfg->timeout_ms : 5000;
+    c->bytes      = HTTP_CLIENT_BYTES +
+                    (cfg->buffer_size    ? cfg->buffer_size    : 512) +
+                    (cfg->buffer_size_tx ? cfg->buffer_size_tx : 512);
+
+    heap_used += c->bytes;
+    return c;
+}
+
+/* host lain = koneksi lama ditutup (seperti esp_http_client) */
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t c, const char *url)
+{
+    char host[HTTP_HOST_LEN];
+
+    url_host(url, host);
+    if (strcmp(host, c->host) != 0)
+    {
+        http_disconnect(c);
+        strcpy(c->host, host);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t c, esp_http_client_method_t m)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t c, const char *key, const char *value)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t c, const char *data, int len)
+{
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t c)
+{
+    // koneksi keep-alive sudah ditutup server: tulis -> RST
+    if (c->connected && http_srv.close_every > 0 &&
+        c->conn_requests >= http_srv.close_every)
+    {
+        sim_advance((int64_t)http_srv.request_ms * 1000000);
+        http_disconnect(c);
+        http_failures++;
+        return ESP_FAIL;
+    }
+
+    if (!c->connected)
+    {
+        if (host_is_down(c->host))
+        {
+            sim_advance((int64_t)c->timeout_ms * 1000000);
+            http_failures++;
+            return ESP_ERR_HTTP_CONNECT;
+        }
+
+        sim_advance((int64_t)http_srv.connect_ms * 1000000);
+        c->connected = true;
+        heap_used   += HTTP_SOCKET_BYTES;
+        http_connects++;
+    }
+
+    sim_advance((int64_t)http_srv.request_ms * 1000000);
+    c->conn_requests++;
+    c->status = http_srv.status;
+
+    if (!c->keep_alive)
+        http_disconnect(c);
+
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t c)
+{
+    return c->status;
+}
+
+esp_err_t esp_http_client_close(esp_http_client_handle_t c)
+{
+    http_disconnect(c);
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t c)
+{
+    if (!c)
+        return ESP_ERR_INVALID_ARG;
+
+    http_disconnect(c);
+    heap_used -= c->bytes;
+    free(c);
+    return ESP_OK;
+}
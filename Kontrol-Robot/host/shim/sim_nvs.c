@@ -0,0 +1,98 @@
+#include "nvs.h"
+
+#include <string.h>
+
+#define NVS_MAX_KEYS   8
+#define NVS_MAX_BLOB   256
+#define NVS_NAME_LEN   16
+
+typedef struct {
+    char   ns[NVS_NAME_LEN];
+    char   key[NVS_NAME_LEN];
+    size_t len;
+    uint8_t data[NVS_MAX_BLOB];
+} nvs_entry_t;
+
+static nvs_entry_t store[NVS_MAX_KEYS];
+static int         n_store;
+
+/* handle = index namespace + 1 */
+static char        open_ns[NVS_MAX_KEYS][NVS_NAME_LEN];
+
+void sim_nvs_erase_all(void)
+{
+    n_store = 0;
+}
+
+esp_err_t nvs_open(const char *ns, nvs_open_mode_t mode, nvs_handle_t *out)
+{
+    (void)mode;
+
+    for (int i = 0; i < NVS_MAX_KEYS; i++)
+    {
+        if (open_ns[i][0] == 0 || strcmp(open_ns[i], ns) == 0)
+        {
+            strncpy(open_ns[i], ns, NVS_NAME_LEN - 1);
+            *out = i + 1;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+static nvs_entry_t *find(nvs_handle_t h, const char *key)
+{
+    for (int i = 0; i < n_store; i++)
+        if (strcmp(store[i].ns, open_ns[h - 1]) == 0 &&
+            strcmp(store[i].key, key) == 0)
+            return &store[i];
+    return NULL;
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t h, const char *key, void *out, size_t *len)
+{
+    nvs_entry_t *e = find(h, key);
+    if (!e)
+        return ESP_ERR_NVS_NOT_FOUND;
+
+    if (out)
+    {
+        if (*len < e->len)
+            return ESP_ERR_INVALID_SIZE;
+        memcpy(out, e->data, e->len);
+    }
+    *len = e->len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t h, const char *key, const void *val, size_t len)
+{
+    nvs_entry_t *e = find(h, key);
+
+    if (len > NVS_MAX_BLOB)
+        return ESP_ERR_INVALID_SIZE;
+
+    if (!e)
+    {
+        if (n_store >= NVS_MAX_KEYS)
+            return ESP_ERR_NO_MEM;
+        e = &store[n_store++];
+        strncpy(e->ns, open_ns[h - 1], NVS_NAME_LEN - 1);
+        strncpy(e->key, key, NVS_NAME_LEN - 1);
+    }
+
+    memcpy(e->data, val, len);
+    e->len = len;
+    return ESP_OK;
+}
+
+esp_err_t nvs_commit(nvs_handle_t h)
+{
+    (void)h;
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t h)
+{
+    (void)h;
+}
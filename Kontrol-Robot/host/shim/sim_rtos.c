@@ -0,0 +1,252 @@
+#include "sim.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+uint32_t sim_tick_hz = 1000;
+
+#define NS_PER_TICK  (1000000000LL / sim_tick_hz)
+
+/*
+ * Satu task: kode firmware dipanggil langsung oleh test.
+ * Blocking = jalankan event (ISR, timer, peer tiruan) di jam virtual
+ * sampai kondisi terpenuhi atau timeout.
+ */
+static int64_t deadline_of(TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY)
+        return INT64_MAX;
+
+    // interrupt tick ke-N setelah sekarang, bukan now + N periode
+    return (sim_now_ns() / NS_PER_TICK + ticks) * NS_PER_TICK;
+}
+
+/* =========================================================
+ *  TASK + NOTIFIKASI
+ * ========================================================= */
+struct sim_task {
+    uint32_t value;
+    bool     pending;
+};
+
+static struct sim_task main_task;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return &main_task;
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    return (TickType_t)(sim_now_ns() / NS_PER_TICK);
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    sim_run_until(deadline_of(ticks));
+}
+
+BaseType_t xTaskNotify(TaskHandle_t t, uint32_t value, eNotifyAction action)
+{
+    switch (action)
+    {
+        case eSetBits:               t->value |= value; break;
+        case eIncrement:             t->value++;        break;
+        case eSetValueWithOverwrite: t->value = value;  break;
+        case eSetValueWithoutOverwrite:
+            if (t->pending)
+                return pdFAIL;
+            t->value = value;
+            break;
+        case eNoAction:
+        default:
+            break;
+    }
+
+    t->pending = true;
+    return pdPASS;
+}
+
+BaseType_t xTaskNotifyFromISR(TaskHandle_t t, uint32_t value,
+                              eNotifyAction action, BaseType_t *woken)
+{
+    if (woken)
+        *woken = pdTRUE;
+    return xTaskNotify(t, value, action);
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t)
+{
+    return xTaskNotify(t, 0, eIncrement);
+}
+
+void vTaskNotifyGiveFromISR(TaskHandle_t t, BaseType_t *woken)
+{
+    xTaskNotifyFromISR(t, 0, eIncrement, woken);
+}
+
+static bool has_value(void *ctx)
+{
+    return ((struct sim_task *)ctx)->value != 0;
+}
+
+static bool has_pending(void *ctx)
+{
+    return ((struct sim_task *)ctx)->pending;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    struct sim_task *t = &main_task;
+
+    if (!sim_wait(has_value, t, deadline_of(ticks)))
+        return 0;
+
+    uint32_t v = t->value;
+    t->value   = clear ? 0 : v - 1;
+    t->pending = false;
+    return v;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t clear_entry, uint32_t clear_exit,
+                           uint32_t *value, TickType_t ticks)
+{
+    struct sim_task *t = &main_task;
+
+    if (!t->pending)
+        t->value &= ~clear_entry;
+
+    if (!sim_wait(has_pending, t, deadline_of(ticks)))
+        return pdFALSE;
+
+    if (value)
+        *value = t->value;
+    t->value  &= ~clear_exit;
+    t->pending = false;
+    return pdTRUE;
+}
+
+BaseType_t xTaskNotifyStateClear(TaskHandle_t t)
+{
+    if (!t)
+        t = &main_task;
+
+    BaseType_t was = t->pending;
+    t->pending = false;
+    return was;
+}
+
+/* =========================================================
+ *  QUEUE / SEMAPHORE
+ * ========================================================= */
+struct sim_queue {
+    uint8_t    *buf;
+    UBaseType_t len;
+    UBaseType_t item_size;
+    UBaseType_t count;
+    UBaseType_t head;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t len, UBaseType_t item_size)
+{
+    struct sim_queue *q = calloc(1, sizeof(*q));
+
+    q->len       = len;
+    q->item_size = item_size;
+    q->buf       = calloc(len ? len : 1, item_size ? item_size : 1);
+    return q;
+}
+
+void vQueueDelete(QueueHandle_t q)
+{
+    free(q->buf);
+    free(q);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void)
+{
+    return xQueueCreate(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    QueueHandle_t q = xQueueCreate(1, 0);
+    q->count = 1;
+    return q;
+}
+
+static void q_put(QueueHandle_t q, const void *item)
+{
+    UBaseType_t slot = (q->head + q->count) % q->len;
+
+    if (q->item_size && item)
+        memcpy(q->buf + slot * q->item_size, item, q->item_size);
+    q->count++;
+}
+
+static bool q_has_space(void *ctx)
+{
+    QueueHandle_t q = ctx;
+    return q->count < q->len;
+}
+
+static bool q_has_item(void *ctx)
+{
+    return ((QueueHandle_t)ctx)->count > 0;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void *item, TickType_t ticks)
+{
+    if (!sim_wait(q_has_space, q, deadline_of(ticks)))
+        return pdFALSE;
+
+    q_put(q, item);
+    return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t q, const void *item, BaseType_t *woken)
+{
+    if (q->count >= q->len)
+        return pdFALSE;
+
+    q_put(q, item);
+    if (woken)
+        *woken = pdTRUE;
+    return pdTRUE;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void *item)
+{
+    q->count = 0;
+    q_put(q, item);
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void *item, TickType_t ticks)
+{
+    if (!sim_wait(q_has_item, q, deadline_of(ticks)))
+        return pdFALSE;
+
+    if (q->item_size && item)
+        memcpy(item, q->buf + q->head * q->item_size, q->item_size);
+    q->head = (q->head + 1) % q->len;
+    q->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueReset(QueueHandle_t q)
+{
+    q->count = 0;
+    q->head  = 0;
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q)
+{
+    return q->count;
+}
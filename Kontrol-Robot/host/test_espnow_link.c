@@ -0,0 +1,311 @@
+/* =========================================================
+ *  TEST: espnow_link_capture() lewat loopback ESP-NOW
+ *  Kamera tiruan di jam virtual: ACK + DONE dengan delay, dedup
+ *  per (MAC, nonce, seq) seperti capture_service_task di
+ *  Testing Code/main.c. Balasan bisa hilang, basi, atau tidak ada.
+ * ========================================================= */
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "esp_now.h"
+#include "esp_random.h"
+
+/* tx_seq / boot_nonce static: dipakai test reboot */
+#include "../main/espnow_link.c"
+
+#define MS  1000000LL
+
+/* ===== STUB conn.c ===== */
+esp_err_t conn_espnow_add_peer(const uint8_t *mac)
+{
+    (void)mac;
+    return ESP_OK;
+}
+
+/* ===== KAMERA TIRUAN ===== */
+#define CAM_ACK_MS    2
+#define CAM_DONE_MS   150
+#define MAX_SENT      64
+
+static const uint8_t ROBOT_MAC[ESP_NOW_ETH_ALEN] = { 0x7c, 0xdf, 0xa1, 0x00, 0x00, 0x01 };
+
+static struct {
+    /* perilaku */
+    int  mac_fail;        // N kirim pertama gagal di MAC layer
+    int  drop_replies;    // N balasan pertama hilang di udara
+    bool silent;          // kamera mati
+    bool stale;           // kirim DONE basi dulu (seq lama, nonce lain)
+
+    /* state kamera (capture_service_task) */
+    bool     have_last;
+    uint8_t  last_mac[ESP_NOW_ETH_ALEN];
+    uint32_t last_nonce;
+    uint16_t last_seq;
+    uint8_t  last_status;
+
+    /* hasil */
+    int          captures;
+    int          n_sent;
+    espnow_msg_t sent[MAX_SENT];
+} cam;
+
+static void cam_reset(void)
+{
+    bool     have_last = cam.have_last;
+    uint8_t  mac[ESP_NOW_ETH_ALEN];
+    uint32_t nonce     = cam.last_nonce;
+    uint16_t seq       = cam.last_seq;
+    uint8_t  status    = cam.last_status;
+
+    memcpy(mac, cam.last_mac, sizeof(mac));
+    memset(&cam, 0, sizeof(cam));
+
+    // ingatan kamera tetap (kamera tidak ikut reboot)
+    cam.have_last   = have_last;
+    cam.last_nonce  = nonce;
+    cam.last_seq    = seq;
+    cam.last_status = status;
+    memcpy(cam.last_mac, mac, sizeof(mac));
+}
+
+static void cam_reply(const uint8_t *mac, const espnow_msg_t *req,
+                      uint8_t cmd, uint8_t status, int64_t delay_ns)
+{
+    if (cam.drop_replies > 0)
+    {
+        cam.drop_replies--;
+        return;
+    }
+
+    espnow_msg_t msg = {
+        .ver    = ESPNOW_PROTO_VER,
+        .cmd    = cmd,
+        .seq    = req->seq,
+        .nonce  = req->nonce,
+        .pot    = req->pot,
+        .status = status,
+    };
+    sim_espnow_recv_after(delay_ns, mac, (const uint8_t *)&msg, sizeof(msg));
+}
+
+/* frame robot -> kamera */
+static void cam_on_send(const uint8_t *mac, const uint8_t *data, int len)
+{
+    espnow_msg_t req;
+
+    SIM_CHECK(len == sizeof(req));
+    memcpy(&req, data, sizeof(req));
+
+    if (cam.n_sent < MAX_SENT)
+        cam.sent[cam.n_sent++] = req;
+
+    if (cam.mac_fail > 0)
+    {
+        cam.mac_fail--;
+        sim_espnow_status_after(1 * MS, ESP_NOW_SEND_FAIL);
+        return;
+    }
+    sim_espnow_status_after(1 * MS, ESP_NOW_SEND_SUCCESS);
+
+    if (cam.silent || req.cmd != CMD_TAKE_PICTURE)
+        return;
+
+    if (cam.stale)
+    {
+        // DONE gagal dari perintah sebelumnya dan dari boot robot lain
+        espnow_msg_t old = req;
+        old.seq--;
+        cam_reply(mac, &old, CMD_DONE, 1, 1 * MS);
+
+        old = req;
+        old.nonce ^= 0x5a5a5a5au;
+        cam_reply(mac, &old, CMD_DONE, 1, 1 * MS);
+    }
+
+    // retransmit: jawab ulang tanpa capture
+    if (cam.have_last && req.seq == cam.last_seq && req.nonce == cam.last_nonce &&
+        memcmp(ROBOT_MAC, cam.last_mac, ESP_NOW_ETH_ALEN) == 0)
+    {
+        cam_reply(mac, &req, CMD_DONE, cam.last_status, 1 * MS);
+        return;
+    }
+
+    cam_reply(mac, &req, CMD_ACK, 0, CAM_ACK_MS * MS);
+
+    cam.captures++;
+    cam.have_last   = true;
+    cam.last_nonce  = req.nonce;
+    cam.last_seq    = req.seq;
+    cam.last_status = 0;
+    memcpy(cam.last_mac, ROBOT_MAC, ESP_NOW_ETH_ALEN);
+
+    cam_reply(mac, &req, CMD_DONE, 0, CAM_DONE_MS * MS);
+}
+
+/* ===== HELPER ===== */
+static bool capture(const char *name, uint16_t pot, int64_t *took_ms)
+{
+    int64_t t0 = sim_now_ns();
+    bool    ok = espnow_link_capture(pot);
+
+    *took_ms = (sim_now_ns() - t0) / MS;
+
+    printf("%-22s %s  %5lld ms  kirim %d  capture %d  seq %u\n",
+           name, ok ? "OK   " : "GAGAL", (long long)*took_ms,
+           cam.n_sent, cam.captures, cam.n_sent ? cam.sent[0].seq : 0);
+
+    // sisa balasan tidak boleh bocor ke test berikutnya
+    sim_advance(ESPNOW_DONE_TIMEOUT_MS * MS);
+    return ok;
+}
+
+static bool all_same_cmd(void)
+{
+    for (int i = 1; i < cam.n_sent; i++)
+    {
+        if (cam.sent[i].seq != cam.sent[0].seq ||
+            cam.sent[i].nonce != cam.sent[0].nonce ||
+            cam.sent[i].pot != cam.sent[0].pot)
+            return false;
+    }
+    return true;
+}
+
+/* ===== TEST ===== */
+static void test_normal(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    SIM_CHECK(capture("normal", 1, &ms));
+    SIM_CHECK(cam.n_sent == 1 && cam.captures == 1);
+    SIM_CHECK(ms >= CAM_DONE_MS && ms < CAM_DONE_MS + 10);
+    SIM_CHECK(cam.sent[0].ver == ESPNOW_PROTO_VER);
+    SIM_CHECK(cam.sent[0].nonce == boot_nonce);
+
+    // perintah berikutnya: seq + 1, nonce sama
+    uint16_t seq = cam.sent[0].seq;
+
+    cam_reset();
+    SIM_CHECK(capture("pot berikutnya", 2, &ms));
+    SIM_CHECK(cam.sent[0].seq == (uint16_t)(seq + 1));
+    SIM_CHECK(cam.sent[0].nonce == boot_nonce);
+    SIM_CHECK(cam.captures == 1);
+}
+
+/* ACK + DONE hilang: kirim ulang seq yang sama, kamera tidak capture 2x */
+static void test_lost_reply(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    cam.drop_replies = 2;
+
+    SIM_CHECK(capture("balasan hilang", 3, &ms));
+    SIM_CHECK(cam.n_sent == 2);
+    SIM_CHECK(all_same_cmd());
+    SIM_CHECK(cam.captures == 1);
+}
+
+/* hanya ACK hilang: DONE tetap diterima dalam jendela tunggu ACK */
+static void test_lost_ack(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    cam.drop_replies = 1;
+
+    SIM_CHECK(capture("ACK hilang", 4, &ms));
+    SIM_CHECK(cam.n_sent == 1 && cam.captures == 1);
+}
+
+/* DONE gagal dengan seq lain / nonce lain harus diabaikan */
+static void test_stale(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    cam.stale = true;
+
+    SIM_CHECK(capture("DONE basi", 5, &ms));
+    SIM_CHECK(cam.n_sent == 1 && cam.captures == 1);
+}
+
+/* MAC layer gagal 2x: kirim ulang setelah jeda */
+static void test_mac_fail(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    cam.mac_fail = 2;
+
+    SIM_CHECK(capture("kirim gagal 2x", 6, &ms));
+    SIM_CHECK(cam.n_sent == 3 && all_same_cmd());
+    SIM_CHECK(cam.captures == 1);
+}
+
+/* kamera mati: gagal setelah ESPNOW_CAPTURE_MAX_MS, seq tidak berubah */
+static void test_timeout(void)
+{
+    int64_t ms;
+
+    cam_reset();
+    cam.silent = true;
+
+    SIM_CHECK(!capture("kamera mati", 7, &ms));
+    SIM_CHECK(ms >= ESPNOW_CAPTURE_MAX_MS && ms <= ESPNOW_CAPTURE_MAX_MS + 10);
+    SIM_CHECK(cam.n_sent >= ESPNOW_CAPTURE_MAX_MS / (2 * ESPNOW_ACK_TIMEOUT_MS));
+    SIM_CHECK(all_same_cmd());
+}
+
+/* robot reboot, seq kebetulan sama dengan yang diingat kamera */
+static void test_reboot(void)
+{
+    int64_t  ms;
+    uint32_t old_nonce = boot_nonce;
+    uint16_t old_seq   = cam.last_seq;
+
+    sim_random_seed(0xc0ffee01u);
+    espnow_link_init();
+
+    SIM_CHECK(boot_nonce != old_nonce);
+
+    tx_seq = (uint16_t)(old_seq - 1);     // paksa tabrakan seq
+
+    cam_reset();
+    SIM_CHECK(capture("reboot, seq sama", 1, &ms));
+    SIM_CHECK(cam.sent[0].seq == old_seq);
+    SIM_CHECK(cam.captures == 1);         // bukan dianggap retransmit
+}
+
+int main(void)
+{
+    sim_reset();
+    sim_log_level = 1;
+    sim_random_seed(0x2545f491u);
+    sim_espnow_on_send(cam_on_send);
+
+    espnow_link_init();
+
+    // seq awal acak, bukan 0/1 setiap boot
+    printf("nonce %08x  seq awal %u\n", (unsigned)boot_nonce, (unsigned)tx_seq);
+    SIM_CHECK(boot_nonce != 0);
+
+    test_normal();
+    test_lost_reply();
+    test_lost_ack();
+    test_stale();
+    test_mac_fail();
+    test_timeout();
+    test_reboot();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
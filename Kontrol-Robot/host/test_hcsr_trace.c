@@ -0,0 +1,364 @@
+/* =========================================================
+ *  TEST: filter HC-SR04 (median + confidence) dengan trace jarak
+ *  Trace = titik (ms, cm) rekaman pendekatan ke pot, diinterpolasi,
+ *  lalu diberi noise, echo hilang (-1), di luar range (-2) dan
+ *  pantulan palsu. Dibandingkan dengan logika lama:
+ *  sampel 200 ms, DETECT_CONFIRM = 3 hit berturut di bawah STOP_CM.
+ * ========================================================= */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim.h"
+
+/* detect_update(), median_push(), filter_reset() bersifat static */
+#include "../main/hcsr.c"
+
+/* ===== STUB (dipakai hcsr_task, tidak dijalankan di sini) ===== */
+SemaphoreHandle_t log_mutex = NULL;
+
+bool wifi_http_post_pot(int pot) { (void)pot; return true; }
+
+void espnow_link_init(void) {}
+bool espnow_link_capture(uint16_t pot) { (void)pot; return true; }
+
+robot_state_t robot_state_get(void) { return ROBOT_RUN; }
+bool robot_event_post(robot_event_t ev, int arg) { (void)ev; (void)arg; return true; }
+
+/* ===== TRACE ===== */
+#define NO_ECHO  -1
+
+typedef struct {
+    int t_ms;
+    int cm;          // NO_ECHO = tidak ada objek
+} trace_pt_t;
+
+typedef struct {
+    int pct_drop;    // % sampel tanpa echo
+    int pct_range;   // % sampel di luar range (-2)
+    int pct_ghost;   // % pantulan palsu 2..4 cm
+    int noise_cm;    // +- noise
+} noise_t;
+
+/* rekaman pendekatan: melambat dari 40 cm (approach limit), bumper di 2 cm */
+static const trace_pt_t pot_approach[] = {
+    {    0, NO_ECHO },
+    {  299, NO_ECHO },
+    {  300, 120 },
+    { 2300,  40 },
+    { 4050,   5 },
+    { 4650,   2 },
+    { 6000,   2 },
+};
+
+/* lorong tanpa pot: dinding samping jauh */
+static const trace_pt_t no_pot[] = {
+    {     0, 150 },
+    {  5000, 180 },
+    { 10000, NO_ECHO },
+    { 15000, 160 },
+    { 20000, 150 },
+};
+
+/* pot 1 berhenti (capture), lalu robot jalan lagi ke pot 2 */
+static const trace_pt_t two_pots[] = {
+    {    0,  40 },
+    { 1750,   5 },
+    { 2350,   2 },
+    { 4000,   2 },   // capture, pot masih di depan
+    { 4600,  30 },   // pot 1 lewat ke samping
+    { 4601, NO_ECHO },
+    { 6000, NO_ECHO },
+    { 6001,  60 },
+    { 8000,   5 },
+    { 8600,   2 },
+    { 9500,   2 },
+};
+
+#define N(a) ((int)(sizeof(a) / sizeof(a[0])))
+
+static int trace_cm(const trace_pt_t *tr, int n, int t)
+{
+    if (t <= tr[0].t_ms)
+        return tr[0].cm;
+
+    for (int i = 1; i < n; i++)
+    {
+        if (t > tr[i].t_ms)
+            continue;
+
+        const trace_pt_t *a = &tr[i - 1], *b = &tr[i];
+        if (a->cm == NO_ECHO || b->cm == NO_ECHO)
+            return a->cm;
+        return a->cm + (b->cm - a->cm) * (t - a->t_ms) / (b->t_ms - a->t_ms);
+    }
+    return tr[n - 1].cm;
+}
+
+/* waktu pertama jarak asli < cm_limit, -1 = tidak pernah */
+static int trace_cross(const trace_pt_t *tr, int n, int cm_limit)
+{
+    for (int t = 0; t <= tr[n - 1].t_ms; t++)
+    {
+        int cm = trace_cm(tr, n, t);
+        if (cm != NO_ECHO && cm < cm_limit)
+            return t;
+    }
+    return -1;
+}
+
+/* ===== NOISE: LCG deterministik ===== */
+static uint32_t rng;
+
+static int rnd(int n)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (int)((rng >> 8) % (uint32_t)n);
+}
+
+/* kontrak hcsr_read_cm(): cm, -1 = timeout, -2 = di luar 2..400 cm */
+static int measure(int cm, const noise_t *nz)
+{
+    int r = rnd(100);
+
+    if (r < nz->pct_drop)
+        return -1;
+    r -= nz->pct_drop;
+    if (r < nz->pct_range)
+        return -2;
+    r -= nz->pct_range;
+    if (r < nz->pct_ghost)
+        return 2 + rnd(3);
+
+    if (cm == NO_ECHO)
+        return -1;
+    if (nz->noise_cm)
+        cm += rnd(2 * nz->noise_cm + 1) - nz->noise_cm;
+    if (cm < 2 || cm > 400)
+        return -2;
+    return cm;
+}
+
+/* ===== LOGIKA ===== */
+typedef struct {
+    int period_ms;
+    int det_ms[8];   // waktu keputusan stop
+    int det_n;
+} run_t;
+
+static void reset_new(void)
+{
+    filter_reset();
+    armed = true;
+}
+
+/* logika baru: setelah stop dianggap capture sukses (seperti hcsr_task) */
+static bool step_new(int d)
+{
+    if (!detect_update(d))
+        return false;
+
+    filter_reset();
+    armed = false;
+    return true;
+}
+
+static int old_count;
+
+static bool step_old(int d)
+{
+    if (d > 0 && d < STOP_CM)
+    {
+        if (++old_count >= 3)
+        {
+            old_count = 0;
+            return true;
+        }
+    }
+    else
+    {
+        old_count = 0;
+    }
+    return false;
+}
+
+static void run_trace(const trace_pt_t *tr, int n, const noise_t *nz,
+                      bool new_logic, uint32_t seed, run_t *out)
+{
+    out->period_ms = new_logic ? SAMPLE_MS_MOVING : 200;
+    out->det_n     = 0;
+
+    rng = seed;
+    reset_new();
+    old_count = 0;
+
+    // fase sampling acak terhadap trace
+    for (int t = rnd(out->period_ms); t <= tr[n - 1].t_ms; t += out->period_ms)
+    {
+        int  d   = measure(trace_cm(tr, n, t), nz);
+        bool hit = new_logic ? step_new(d) : step_old(d);
+
+        if (hit && out->det_n < N(out->det_ms))
+            out->det_ms[out->det_n++] = t;
+    }
+}
+
+/* ===== STATISTIK ===== */
+#define RUNS  500
+
+/* stop di jarak asli < STOP_CM + margin masih benar (resolusi 1 cm + noise) */
+#define EARLY_MARGIN_CM  2
+
+typedef struct {
+    int missed;      // pot tidak terdeteksi
+    int false_stop;  // stop tanpa pot / jarak asli masih jauh
+    int lat_sum, lat_max, lat_n;
+} stat_t;
+
+static stat_t run_many(const char *name, const trace_pt_t *tr, int n,
+                       const noise_t *nz, bool new_logic)
+{
+    stat_t s = { 0 };
+    int cross = trace_cross(tr, n, STOP_CM);
+    int early = trace_cross(tr, n, STOP_CM + EARLY_MARGIN_CM);
+
+    for (int k = 0; k < RUNS; k++)
+    {
+        run_t r;
+        run_trace(tr, n, nz, new_logic, 0x9e3779b9u * (k + 1), &r);
+
+        int first = -1;
+        for (int i = 0; i < r.det_n; i++)
+        {
+            if (cross < 0 || r.det_ms[i] < early)
+                s.false_stop++;
+            else if (first < 0)
+                first = r.det_ms[i];
+        }
+
+        if (cross < 0)
+            continue;
+        if (first < 0)
+        {
+            s.missed++;
+            continue;
+        }
+
+        int lat = first > cross ? first - cross : 0;
+        s.lat_sum += lat;
+        s.lat_n++;
+        if (lat > s.lat_max)
+            s.lat_max = lat;
+    }
+
+    printf("%-16s %-5s %3d x  miss %3d  false stop %3d",
+           name, new_logic ? "baru" : "lama", RUNS, s.missed, s.false_stop);
+    if (s.lat_n)
+        printf("  latency rata %4d ms maks %4d ms",
+               s.lat_sum / s.lat_n, s.lat_max);
+    printf("\n");
+
+    return s;
+}
+
+static int lat_avg(const stat_t *s)
+{
+    return s->lat_n ? s->lat_sum / s->lat_n : 1 << 30;
+}
+
+/* ===== TEST ===== */
+static void test_median(void)
+{
+    reset_new();
+    SIM_CHECK(median_push(10) == 10);
+    SIM_CHECK(median_push(3)  == 10);     // 2 sampel: ambil yang atas
+    SIM_CHECK(median_push(50) == 10);
+    SIM_CHECK(median_push(4)  == 4);      // {4, 3, 50}
+    SIM_CHECK(median_push(400) == 50);    // {4, 400, 50}
+
+    // 1 pantulan palsu di antara jarak jauh tidak lolos median
+    reset_new();
+    SIM_CHECK(!detect_update(-1));
+    SIM_CHECK(!detect_update(3));
+    SIM_CHECK(!detect_update(-1));
+    SIM_CHECK(hcsr_get_distance_cm() == -1);
+
+    // -2 diabaikan: tidak mengisi histori
+    reset_new();
+    detect_update(30);
+    SIM_CHECK(!detect_update(-2));
+    SIM_CHECK(hcsr_get_distance_cm() == 30);
+}
+
+static void test_approach(void)
+{
+    static const noise_t clean = { 0 };
+    static const noise_t noisy = { .pct_drop = 10, .pct_range = 3,
+                                   .pct_ghost = 0, .noise_cm = 1 };
+
+    stat_t a_new = run_many("pot bersih",  pot_approach, N(pot_approach), &clean, true);
+    stat_t a_old = run_many("pot bersih",  pot_approach, N(pot_approach), &clean, false);
+    stat_t b_new = run_many("pot + noise", pot_approach, N(pot_approach), &noisy, true);
+    stat_t b_old = run_many("pot + noise", pot_approach, N(pot_approach), &noisy, false);
+
+    SIM_CHECK(a_new.missed == 0 && a_new.false_stop == 0);
+    SIM_CHECK(b_new.missed == 0 && b_new.false_stop == 0);
+
+    // 1 sampel isi median + 4 hit: maks 5 periode setelah lewat
+    SIM_CHECK(a_new.lat_max <= 5 * SAMPLE_MS_MOVING);
+
+    SIM_CHECK(lat_avg(&a_new) < lat_avg(&a_old));
+    SIM_CHECK(lat_avg(&b_new) < lat_avg(&b_old));
+    SIM_CHECK(b_new.lat_max <= b_old.lat_max);
+    SIM_CHECK(b_new.missed <= b_old.missed);
+}
+
+static void test_false_stop(void)
+{
+    static const noise_t ghost = { .pct_drop = 10, .pct_range = 3,
+                                   .pct_ghost = 3, .noise_cm = 2 };
+
+    stat_t n_new = run_many("tanpa pot", no_pot, N(no_pot), &ghost, true);
+    stat_t n_old = run_many("tanpa pot", no_pot, N(no_pot), &ghost, false);
+
+    // sampling 3x lebih rapat tidak boleh menambah stop palsu
+    SIM_CHECK(n_new.false_stop <= n_old.false_stop);
+    SIM_CHECK(n_new.false_stop * 100 <= RUNS);    // <= 1 % run
+}
+
+/* setelah capture: pot yang sama tidak memicu lagi sampai lewat REARM_CM */
+static void test_rearm(void)
+{
+    static const noise_t noisy = { .pct_drop = 10, .pct_range = 3,
+                                   .pct_ghost = 0, .noise_cm = 1 };
+    int bad = 0;
+
+    for (int k = 0; k < RUNS; k++)
+    {
+        run_t r;
+        run_trace(two_pots, N(two_pots), &noisy, true, 0x85ebca6bu * (k + 1), &r);
+
+        // tepat 1 stop per pot, pot 2 setelah pot 1 lewat
+        if (r.det_n != 2 || r.det_ms[0] > 4000 || r.det_ms[1] < 6000)
+            bad++;
+    }
+
+    printf("%-16s %-5s %3d x  salah %d\n", "2 pot (rearm)", "baru", RUNS, bad);
+    SIM_CHECK(bad == 0);
+}
+
+int main(void)
+{
+    test_median();
+    test_approach();
+    test_false_stop();
+    test_rearm();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,245 @@
+/* =========================================================
+ *  TEST: http_pool_request() dengan server tiruan (loopback)
+ *  Reuse koneksi keep-alive, reconnect saat server menutup,
+ *  host mati, beberapa host, heap stabil, lalu benchmark
+ *  dibanding 1 client baru per request (cara lama).
+ * ========================================================= */
+#include <stdio.h>
+#include <string.h>
+
+#include "sim.h"
+#include "esp_http_client.h"
+#include "esp_system.h"
+
+/* slot & stats static: di-reset antar test */
+#include "../main/http_pool.c"
+
+#define HOST_A   "192.168.4.2:8000"
+#define HOST_B   "192.168.4.3:8000"
+#define HOST_C   "192.168.4.4:8000"
+#define URL_A    "http://" HOST_A "/pot"
+#define URL_A2   "http://" HOST_A "/dht"
+#define URL_B    "http://" HOST_B "/telemetry"
+#define URL_C    "http://" HOST_C "/log"
+
+#define MS       1000000LL
+#define BODY     "{\"pot\":1}"
+
+static uint32_t heap_start;
+
+static const sim_http_server_t srv_default = {
+    .connect_ms  = 30,
+    .request_ms  = 15,
+    .close_every = 0,
+    .status      = 200,
+};
+
+static void pool_reset(const sim_http_server_t *srv)
+{
+    for (int i = 0; i < POOL_MAX_HOSTS; i++)
+    {
+        slot_drop(&slots[i]);
+        slots[i].host[0] = 0;
+    }
+    memset(&stats, 0, sizeof(stats));
+    total_ms = 0;
+
+    sim_http_reset(srv);
+}
+
+static int post(const char *url)
+{
+    return http_pool_request(HTTP_METHOD_POST, url, "application/json",
+                             BODY, sizeof(BODY) - 1);
+}
+
+/* cara lama: client baru per request, tanpa keep-alive */
+static int post_oneshot(const char *url)
+{
+    esp_http_client_config_t cfg = {
+        .url        = url,
+        .method     = HTTP_METHOD_POST,
+        .timeout_ms = POOL_TIMEOUT_MS,
+    };
+    esp_http_client_handle_t c = esp_http_client_init(&cfg);
+
+    esp_http_client_set_header(c, "Content-Type", "application/json");
+    esp_http_client_set_post_field(c, BODY, sizeof(BODY) - 1);
+
+    int status = -1;
+    if (esp_http_client_perform(c) == ESP_OK)
+        status = esp_http_client_get_status_code(c);
+
+    esp_http_client_cleanup(c);
+    return status;
+}
+
+/* ===== TEST ===== */
+static void test_reuse(void)
+{
+    pool_reset(&srv_default);
+
+    for (int i = 0; i < 20; i++)
+        SIM_CHECK(post(i & 1 ? URL_A2 : URL_A) == 200);
+
+    http_pool_stats_t st;
+    http_pool_get_stats(&st);
+
+    printf("reuse        req %2lu conn %lu err %lu avg %lu ms\n",
+           (unsigned long)st.requests, (unsigned long)st.connects,
+           (unsigned long)st.errors, (unsigned long)st.avg_ms);
+
+    // path beda, host sama: satu koneksi
+    SIM_CHECK(st.connects == 1 && sim_http_connects() == 1);
+    SIM_CHECK(st.errors == 0);
+    SIM_CHECK(st.max_ms == (uint32_t)(srv_default.connect_ms + srv_default.request_ms));
+    SIM_CHECK(st.last_ms == (uint32_t)srv_default.request_ms);
+}
+
+/* server menutup keep-alive: gagal 1x di koneksi lama, reconnect di request yang sama */
+static void test_reconnect(void)
+{
+    sim_http_server_t srv = srv_default;
+    srv.close_every = 5;
+    pool_reset(&srv);
+
+    for (int i = 0; i < 20; i++)
+        SIM_CHECK(post(URL_A) == 200);
+
+    http_pool_stats_t st;
+    http_pool_get_stats(&st);
+
+    printf("reconnect    req %2lu conn %lu err %lu gagal-di-server %lu\n",
+           (unsigned long)st.requests, (unsigned long)st.connects,
+           (unsigned long)st.errors, (unsigned long)sim_http_failures());
+
+    SIM_CHECK(st.errors == 0);
+    SIM_CHECK(st.connects == 4);
+    SIM_CHECK(sim_http_failures() == 3);
+}
+
+/* host mati: -1 setelah 2x timeout connect, lalu pulih */
+static void test_host_down(void)
+{
+    pool_reset(&srv_default);
+
+    SIM_CHECK(post(URL_A) == 200);
+
+    // server mati dan koneksi lama putus (mis. WiFi reconnect)
+    sim_http_host_down(HOST_A, true);
+    slot_drop(&slots[0]);
+
+    int64_t t0 = sim_now_ns();
+    SIM_CHECK(post(URL_A) == -1);
+    int64_t took_ms = (sim_now_ns() - t0) / MS;
+
+    sim_http_host_down(HOST_A, false);
+    SIM_CHECK(post(URL_A) == 200);
+
+    http_pool_stats_t st;
+    http_pool_get_stats(&st);
+
+    printf("host mati    req %2lu conn %lu err %lu gagal %lld ms\n",
+           (unsigned long)st.requests, (unsigned long)st.connects,
+           (unsigned long)st.errors, (long long)took_ms);
+
+    SIM_CHECK(st.errors == 1);
+    SIM_CHECK(took_ms == 2 * POOL_TIMEOUT_MS);
+}
+
+/* 2 host bergantian: 1 koneksi per host. Host ke-3 mengusir slot 0 */
+static void test_multi_host(void)
+{
+    pool_reset(&srv_default);
+
+    for (int i = 0; i < 10; i++)
+    {
+        SIM_CHECK(post(URL_A) == 200);
+        SIM_CHECK(post(URL_B) == 200);
+    }
+    SIM_CHECK(sim_http_connects() == 2);
+
+    SIM_CHECK(post(URL_C) == 200);       // slot 0 (A) dipakai C
+    SIM_CHECK(post(URL_B) == 200);       // B tetap
+    SIM_CHECK(sim_http_connects() == 3);
+
+    SIM_CHECK(post(URL_A) == 200);       // A connect lagi
+    SIM_CHECK(sim_http_connects() == 4);
+
+    printf("multi host   conn %lu\n", (unsigned long)sim_http_connects());
+}
+
+/* heap: setelah koneksi pertama tidak ada kebocoran per request */
+static void test_heap(void)
+{
+    pool_reset(&srv_default);
+
+    post(URL_A);
+    uint32_t heap0 = esp_get_free_heap_size();
+
+    for (int i = 0; i < 200; i++)
+        post(URL_A);
+
+    printf("heap         delta %ld byte setelah 200 req\n",
+           (long)esp_get_free_heap_size() - (long)heap0);
+    SIM_CHECK(esp_get_free_heap_size() == heap0);
+
+    pool_reset(&srv_default);
+    SIM_CHECK(esp_get_free_heap_size() == heap_start);
+}
+
+/* ===== BENCHMARK ===== */
+#define BENCH_N  100
+
+static void bench(void)
+{
+    pool_reset(&srv_default);
+
+    int64_t t0 = sim_now_ns();
+    for (int i = 0; i < BENCH_N; i++)
+        SIM_CHECK(post_oneshot(i % 3 ? URL_A : URL_B) == 200);
+    int64_t   one_ms   = (sim_now_ns() - t0) / MS;
+    uint32_t  one_conn = sim_http_connects();
+
+    pool_reset(&srv_default);
+
+    t0 = sim_now_ns();
+    for (int i = 0; i < BENCH_N; i++)
+        SIM_CHECK(post(i % 3 ? URL_A : URL_B) == 200);
+    int64_t   pool_ms   = (sim_now_ns() - t0) / MS;
+    uint32_t  pool_conn = sim_http_connects();
+
+    printf("\n== benchmark %d POST (connect %d ms, request %d ms) ==\n",
+           BENCH_N, srv_default.connect_ms, srv_default.request_ms);
+    printf("1 client/req %6lld ms  %5.1f ms/req  connect %3lu\n",
+           (long long)one_ms, (double)one_ms / BENCH_N, (unsigned long)one_conn);
+    printf("http_pool    %6lld ms  %5.1f ms/req  connect %3lu\n",
+           (long long)pool_ms, (double)pool_ms / BENCH_N, (unsigned long)pool_conn);
+
+    SIM_CHECK(one_conn == BENCH_N);
+    SIM_CHECK(pool_conn == 2);
+    SIM_CHECK(pool_ms < one_ms);
+}
+
+int main(void)
+{
+    sim_reset();
+    sim_log_level = 1;
+    heap_start    = esp_get_free_heap_size();
+
+    test_reuse();
+    test_reconnect();
+    test_host_down();
+    test_multi_host();
+    test_heap();
+    bench();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
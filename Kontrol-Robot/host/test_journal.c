@@ -0,0 +1,249 @@
+/* =========================================================
+ *  TEST: journal.c di atas partisi flash tiruan (tmpfile, NOR)
+ *  Append, urutan replay, consume, reboot (scan ulang),
+ *  ring penuh (sektor tertua dibuang), tulis terpotong,
+ *  pot di antara DHT (urutan, seq dan boot tetap setelah reboot).
+ * ========================================================= */
+#include <stdio.h>
+
+#include "sim.h"
+#include "journal.h"
+#include "esp_partition.h"
+
+#define SECTORS          3
+#define RECS_PER_SECTOR  (SIM_FLASH_SECTOR / 32)
+#define SLOTS            (SECTORS * RECS_PER_SECTOR)
+
+static journal_entry_t ent[SLOTS];
+
+/* reboot: state RAM journal dibangun ulang dari flash */
+static void reboot(void)
+{
+    SIM_CHECK(journal_init() == ESP_OK);
+}
+
+static void append_n(int first, int n)
+{
+    for (int i = first; i < first + n; i++)
+        SIM_CHECK(journal_append(JOURNAL_DHT, i, -i) == ESP_OK);
+}
+
+/* semua pending: seq naik, nilai berurutan mulai first_v */
+static bool check_order(int first_v, int n)
+{
+    int got = journal_peek(ent, SLOTS);
+
+    if (got != n || (uint32_t)n != journal_pending())
+        return false;
+
+    for (int i = 0; i < n; i++)
+    {
+        if (ent[i].type != JOURNAL_DHT || ent[i].v0 != first_v + i ||
+            ent[i].v1 != -(first_v + i))
+            return false;
+        if (i && ent[i].seq <= ent[i - 1].seq)
+            return false;
+    }
+    return true;
+}
+
+/* ===== TEST ===== */
+static void test_no_partition(void)
+{
+    sim_flash_init(JOURNAL_PARTITION, 0);
+
+    SIM_CHECK(journal_init() == ESP_ERR_NOT_FOUND);
+    SIM_CHECK(!journal_ready());
+    SIM_CHECK(journal_append(JOURNAL_DHT, 1, 2) == ESP_ERR_INVALID_STATE);
+    SIM_CHECK(journal_peek(ent, SLOTS) == 0);
+}
+
+static void test_append_consume(void)
+{
+    sim_flash_init(JOURNAL_PARTITION, SECTORS * SIM_FLASH_SECTOR);
+    reboot();
+
+    SIM_CHECK(journal_ready());
+    SIM_CHECK(journal_pending() == 0);
+    SIM_CHECK(journal_boot() == 1);
+
+    append_n(100, 10);
+    SIM_CHECK(check_order(100, 10));
+
+    // peek tidak menghapus, max dihormati
+    SIM_CHECK(journal_peek(ent, 3) == 3 && ent[0].v0 == 100 && ent[2].v0 == 102);
+    SIM_CHECK(journal_pending() == 10);
+
+    journal_consume(4);
+    SIM_CHECK(check_order(104, 6));
+
+    printf("append       pending %lu, boot %u\n",
+           (unsigned long)journal_pending(), journal_boot());
+}
+
+/* lanjutan test_append_consume: isi flash dipakai lagi */
+static void test_reboot(void)
+{
+    uint32_t last_seq = ent[5].seq;
+
+    reboot();
+
+    SIM_CHECK(journal_boot() == 2);
+    SIM_CHECK(check_order(104, 6));
+    SIM_CHECK(ent[0].boot == 1);
+
+    append_n(110, 2);
+    SIM_CHECK(check_order(104, 8));
+    SIM_CHECK(ent[6].seq > last_seq);
+    SIM_CHECK(ent[6].boot == 2);
+
+    journal_consume(8);
+    SIM_CHECK(journal_pending() == 0);
+
+    reboot();
+    SIM_CHECK(journal_pending() == 0);
+    SIM_CHECK(journal_boot() == 3);
+
+    printf("reboot       boot %u, pending %lu\n",
+           journal_boot(), (unsigned long)journal_pending());
+}
+
+/* pot offline di antara DHT: replay urut, stempel (boot, seq, t_ms) ikut */
+static void test_pot_mixed(void)
+{
+    sim_flash_init(JOURNAL_PARTITION, SECTORS * SIM_FLASH_SECTOR);
+    reboot();
+
+    append_n(0, 3);
+    sim_advance(1000 * 1000000LL);
+    SIM_CHECK(journal_append(JOURNAL_POT, 7, 0) == ESP_OK);
+    append_n(3, 2);
+    SIM_CHECK(journal_append(JOURNAL_POT, 8, 0) == ESP_OK);
+
+    reboot();
+
+    static const uint8_t want_type[] = {
+        JOURNAL_DHT, JOURNAL_DHT, JOURNAL_DHT, JOURNAL_POT,
+        JOURNAL_DHT, JOURNAL_DHT, JOURNAL_POT,
+    };
+    int n = journal_peek(ent, SLOTS);
+
+    SIM_CHECK(n == 7);
+    for (int i = 0; i < n && i < 7; i++)
+    {
+        SIM_CHECK(ent[i].type == want_type[i]);
+        SIM_CHECK(ent[i].boot == 1);
+        if (i)
+            SIM_CHECK(ent[i].seq > ent[i - 1].seq);
+    }
+    SIM_CHECK(ent[3].v0 == 7 && ent[6].v0 == 8);
+    SIM_CHECK(ent[3].t_ms >= ent[2].t_ms + 1000);
+
+    journal_consume(n);
+    SIM_CHECK(journal_pending() == 0);
+
+    printf("pot          %d record campur, boot %u\n", n, journal_boot());
+}
+
+/* ring penuh: sektor tertua dihapus, sisanya tetap urut & terbaru */
+static void test_wrap(void)
+{
+    const int total = 5 * SLOTS + 17;
+
+    sim_flash_init(JOURNAL_PARTITION, SECTORS * SIM_FLASH_SECTOR);
+    reboot();
+
+    append_n(0, total);
+
+    uint32_t pending = journal_pending();
+    int      first   = total - (int)pending;
+
+    printf("wrap         %d append, pending %lu, erase %lu\n",
+           total, (unsigned long)pending, (unsigned long)sim_flash_erases());
+
+    // sektor head dihapus saat dimasuki: hilang maks 1 sektor
+    SIM_CHECK(pending <= SLOTS);
+    SIM_CHECK(pending >= SLOTS - RECS_PER_SECTOR);
+    SIM_CHECK(check_order(first, (int)pending));
+
+    // sama setelah reboot
+    reboot();
+    SIM_CHECK(check_order(first, (int)pending));
+
+    // consume sebagian melewati batas sektor, lalu wrap lagi
+    journal_consume(RECS_PER_SECTOR + 5);
+    first   += RECS_PER_SECTOR + 5;
+    pending -= RECS_PER_SECTOR + 5;
+    SIM_CHECK(check_order(first, (int)pending));
+
+    append_n(total, 2 * RECS_PER_SECTOR);
+    pending = journal_pending();
+    SIM_CHECK(check_order(total + 2 * RECS_PER_SECTOR - (int)pending, (int)pending));
+
+    reboot();
+    SIM_CHECK(check_order(total + 2 * RECS_PER_SECTOR - (int)pending, (int)pending));
+
+    journal_consume((int)pending);
+    SIM_CHECK(journal_pending() == 0);
+    reboot();
+    SIM_CHECK(journal_pending() == 0);
+}
+
+/* reset saat program record: slot rusak dilewati, record utuh tetap */
+static void test_torn_write(void)
+{
+    sim_flash_init(JOURNAL_PARTITION, SECTORS * SIM_FLASH_SECTOR);
+    reboot();
+
+    append_n(0, 3);
+
+    sim_flash_tear_next_write(10);
+    journal_append(JOURNAL_DHT, 99, -99);    // "reset" di tengah write
+
+    reboot();
+    SIM_CHECK(check_order(0, 3));
+
+    append_n(3, 3);
+    SIM_CHECK(check_order(0, 6));
+
+    reboot();
+    SIM_CHECK(check_order(0, 6));
+
+    // record terpotong di akhir sektor: append berikutnya pindah sektor
+    sim_flash_init(JOURNAL_PARTITION, SECTORS * SIM_FLASH_SECTOR);
+    reboot();
+    append_n(0, RECS_PER_SECTOR - 1);
+    sim_flash_tear_next_write(20);
+    journal_append(JOURNAL_DHT, 999, -999);
+
+    reboot();
+    append_n(RECS_PER_SECTOR - 1, 2);
+    SIM_CHECK(check_order(0, RECS_PER_SECTOR + 1));
+
+    printf("torn write   pending %lu\n", (unsigned long)journal_pending());
+}
+
+int main(void)
+{
+    sim_reset();
+    sim_log_level = 1;
+
+    test_no_partition();
+    test_append_consume();
+    test_reboot();
+    test_pot_mixed();
+    test_wrap();
+    test_torn_write();
+
+    // journal tidak pernah menulis 0 -> 1 tanpa erase
+    SIM_CHECK(sim_flash_bad_writes() == 0);
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
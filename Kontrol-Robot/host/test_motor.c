@@ -0,0 +1,151 @@
+/* =========================================================
+ *  TEST: motor_set() — skala perintah linear di atas deadband
+ *  (tanpa snap ke PWM_START_MIN), kick-start, dan hysteresis
+ *  zero-crossing: roda yang berayun di sekitar 0 tidak balik
+ *  arah / kick ulang tiap tick.
+ * ========================================================= */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "sim.h"
+#include "motor.h"
+#include "driver/ledc.h"
+
+#define PWM_MAX        8191
+#define PWM_START_MIN  4200
+#define PWM_KICK       6500
+#define ZERO_HYST      400
+
+#define MS  1000000LL
+
+/* pin arah roda kiri (motor.c) */
+#define PIN_IN1  15
+#define PIN_IN2  16
+
+static int duty_left(void)
+{
+    return (int)sim_ledc_duty(LEDC_CHANNEL_0);
+}
+
+static int dir_left(void)
+{
+    int fwd = sim_gpio_output(PIN_IN1);
+    int rev = sim_gpio_output(PIN_IN2);
+
+    return fwd && !rev ? 1 : (rev && !fwd ? -1 : 0);
+}
+
+/* 1 tick kontrol 5 ms */
+static void tick(int cmd)
+{
+    sim_advance(5 * MS);
+    motor_set(cmd, cmd);
+}
+
+/* duty = deadband + |cmd| * (PWM_MAX - deadband) / PWM_MAX, monoton */
+static void test_linear(void)
+{
+    static const int cmds[] = {
+        1, 100, 300, 800, 1700, 3490, 5000, 8191, 9000,
+        -1, -300, -1000, -4000, -8191,
+    };
+    int prev_mag = 0, prev_duty = 0;
+
+    for (unsigned i = 0; i < sizeof(cmds) / sizeof(cmds[0]); i++)
+    {
+        int c   = cmds[i];
+        int mag = abs(c) > PWM_MAX ? PWM_MAX : abs(c);
+        int want = (int)(PWM_START_MIN + (float)mag * (PWM_MAX - PWM_START_MIN) / PWM_MAX);
+
+        motor_stop();
+        motor_set(c, c);
+        sim_advance(100 * MS);          // lewati kick-start
+        motor_set(c, c);
+
+        printf("cmd %5d -> duty %4d %s\n", c, duty_left(),
+               dir_left() > 0 ? "maju" : (dir_left() < 0 ? "mundur" : "-"));
+
+        SIM_CHECK(duty_left() == want);
+        SIM_CHECK(dir_left() == (c > 0 ? 1 : -1));
+
+        // perintah kecil beda = duty beda (bukan snap ke deadband)
+        if (c > 0 && prev_mag > 0 && mag > prev_mag + 100)
+            SIM_CHECK(duty_left() > prev_duty);
+        if (c > 0)
+        {
+            prev_mag  = mag;
+            prev_duty = duty_left();
+        }
+    }
+
+    motor_stop();
+    motor_set(0, 0);
+    SIM_CHECK(duty_left() == 0 && dir_left() == 0);
+}
+
+/* roda dalam berayun di sekitar 0: tanpa balik arah, tanpa kick */
+static void test_zero_hysteresis(void)
+{
+    static const int wobble[] = { 300, -200, 150, -350, 50, -100, 250, -399 };
+    int kicks = 0, reversals = 0;
+
+    motor_stop();
+    motor_set(2000, 2000);
+    for (int i = 0; i < 20; i++)
+        tick(2000);
+    SIM_CHECK(dir_left() == 1 && duty_left() < PWM_KICK);
+
+    for (int r = 0; r < 10; r++)
+    {
+        for (unsigned i = 0; i < sizeof(wobble) / sizeof(wobble[0]); i++)
+        {
+            tick(wobble[i]);
+
+            if (duty_left() >= PWM_KICK)
+                kicks++;
+            if (dir_left() < 0)
+                reversals++;
+
+            // sisi lawan di dalam pita = coast
+            if (wobble[i] < 0)
+                SIM_CHECK(duty_left() == 0);
+            else
+                SIM_CHECK(dir_left() == 1 && duty_left() > PWM_START_MIN);
+        }
+    }
+
+    printf("berayun +-%d: kick %d, balik arah %d\n", ZERO_HYST, kicks, reversals);
+    SIM_CHECK(kicks == 0 && reversals == 0);
+
+    // keluar pita: satu kali balik arah dengan kick
+    tick(-1000);
+    SIM_CHECK(dir_left() == -1 && duty_left() == PWM_KICK);
+    for (int i = 0; i < 20; i++)
+        tick(-1000);
+    SIM_CHECK(dir_left() == -1 && duty_left() < PWM_KICK);
+
+    // sekarang pita berlaku ke arah maju
+    tick(200);
+    SIM_CHECK(duty_left() == 0);
+    tick(600);
+    SIM_CHECK(dir_left() == 1 && duty_left() == PWM_KICK);
+}
+
+int main(void)
+{
+    sim_reset();
+    motor_init();
+    motor_set_accel(0);
+
+    test_linear();
+    test_zero_hysteresis();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
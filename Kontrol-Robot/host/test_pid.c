@@ -0,0 +1,179 @@
+/* =========================================================
+ *  TEST: pid_update() — step, ramp, anti-windup, filter D,
+ *  gain scheduling. Tanpa shim hardware, hanya pid.c.
+ * ========================================================= */
+#include <stdio.h>
+#include <math.h>
+
+#include "sim.h"
+#include "pid.h"
+
+#define DT  0.005f   // 200 Hz, sama dengan loop line follower
+
+static bool near(float a, float b, float tol)
+{
+    return fabsf(a - b) <= tol;
+}
+
+/* step error: P langsung, I naik linear, D tanpa kick di sampel pertama */
+static void test_step(void)
+{
+    pid_ctrl_t pid;
+    pid_init(&pid, (pid_gains_t){ .kp = 2.0f, .ki = 10.0f, .kd = 0.5f },
+             -1000.0f, 1000.0f);
+
+    float out = pid_update(&pid, 10.0f, DT);
+    printf("step  n=1   out %8.3f\n", out);
+    SIM_CHECK(near(out, 20.0f + 10.0f * 10.0f * DT, 1e-3f));
+
+    for (int i = 1; i < 200; i++)
+        out = pid_update(&pid, 10.0f, DT);
+
+    // 1 s: integral = ki * e * t = 100
+    printf("step  t=1s  out %8.3f\n", out);
+    SIM_CHECK(near(out, 20.0f + 100.0f, 0.05f));
+}
+
+/* ramp error: D (setelah filter settle) = kd * slope, P mengikuti error */
+static void test_ramp(void)
+{
+    const float slope = 400.0f;   // unit posisi per detik
+    pid_ctrl_t pid;
+
+    pid_init(&pid, (pid_gains_t){ .kp = 0.0f, .ki = 0.0f, .kd = 0.1f },
+             -1000.0f, 1000.0f);
+    pid.d_tau = 0.02f;
+
+    float out = 0.0f;
+    for (int i = 0; i < 100; i++)
+        out = pid_update(&pid, slope * DT * i, DT);
+
+    printf("ramp  D     out %8.3f (kd*slope %.1f)\n", out, 0.1f * slope);
+    SIM_CHECK(near(out, 0.1f * slope, 0.1f));
+
+    pid_init(&pid, (pid_gains_t){ .kp = 0.5f, .ki = 0.0f, .kd = 0.0f },
+             -1000.0f, 1000.0f);
+    for (int i = 0; i < 100; i++)
+    {
+        float e = slope * DT * i;
+        out = pid_update(&pid, e, DT);
+        SIM_CHECK(near(out, 0.5f * e, 1e-3f));
+    }
+}
+
+/* saturasi: integral berhenti, keluar saturasi cepat saat error berbalik */
+static void test_windup(void)
+{
+    pid_ctrl_t pid;
+    pid_init(&pid, (pid_gains_t){ .kp = 1.0f, .ki = 50.0f, .kd = 0.0f },
+             -100.0f, 100.0f);
+    pid.i_limit = 80.0f;
+
+    float out = 0.0f;
+    for (int i = 0; i < 2000; i++)      // 10 s tersaturasi
+        out = pid_update(&pid, 200.0f, DT);
+
+    printf("windup      out %8.3f integral %8.3f\n", out, pid.integral);
+    SIM_CHECK(near(out, 100.0f, 1e-3f));
+    SIM_CHECK(pid.integral <= 80.0f);
+
+    // error berbalik: dalam beberapa tick output harus negatif
+    int n = 0;
+    do {
+        out = pid_update(&pid, -50.0f, DT);
+        n++;
+    } while (out >= 0.0f && n < 1000);
+
+    printf("windup      lepas saturasi %d tick\n", n);
+    SIM_CHECK(n <= 20);
+
+    // clamp i_limit tanpa saturasi output
+    pid_init(&pid, (pid_gains_t){ .kp = 0.0f, .ki = 50.0f, .kd = 0.0f },
+             -1000.0f, 1000.0f);
+    pid.i_limit = 30.0f;
+    for (int i = 0; i < 1000; i++)
+        out = pid_update(&pid, 5.0f, DT);
+    SIM_CHECK(near(out, 30.0f, 1e-3f));
+}
+
+/* step ke D: tanpa filter = spike 1 sampel, dengan filter = orde 1 */
+static void test_d_filter(void)
+{
+    pid_ctrl_t raw, filt;
+    const pid_gains_t g = { .kp = 0.0f, .ki = 0.0f, .kd = 0.1f };
+
+    pid_init(&raw,  g, -1e6f, 1e6f);
+    pid_init(&filt, g, -1e6f, 1e6f);
+    filt.d_tau = 0.02f;
+
+    pid_update(&raw,  0.0f, DT);
+    pid_update(&filt, 0.0f, DT);
+
+    float r1 = pid_update(&raw,  100.0f, DT);
+    float f1 = pid_update(&filt, 100.0f, DT);
+    float r2 = pid_update(&raw,  100.0f, DT);
+    float f2 = pid_update(&filt, 100.0f, DT);
+
+    float spike = 0.1f * 100.0f / DT;
+    float a     = DT / (0.02f + DT);
+
+    printf("D     raw   %8.3f %8.3f\n", r1, r2);
+    printf("D     filt  %8.3f %8.3f\n", f1, f2);
+
+    SIM_CHECK(near(r1, spike, 1e-2f));
+    SIM_CHECK(near(r2, 0.0f, 1e-3f));
+    SIM_CHECK(near(f1, spike * a, 1e-2f));
+    SIM_CHECK(near(f2, spike * a * (1.0f - a), 1e-2f));
+}
+
+/* schedule: pilih baris menurut |x|, ganti gain tanpa lonjakan I */
+static void test_schedule(void)
+{
+    static const pid_sched_t sched[] = {
+        {  800, { .kp = 0.4f, .ki = 1.0f, .kd = 0.0f } },
+        { 2000, { .kp = 0.6f, .ki = 1.0f, .kd = 0.0f } },
+        { 3500, { .kp = 0.8f, .ki = 0.0f, .kd = 0.0f } },
+    };
+    pid_ctrl_t pid;
+
+    pid_init(&pid, sched[0].gains, -8191.0f, 8191.0f);
+    pid_set_schedule(&pid, sched, 3);
+
+    pid_schedule(&pid, -500.0f);
+    SIM_CHECK(pid.gains.kp == 0.4f);
+    pid_schedule(&pid, 1500.0f);
+    SIM_CHECK(pid.gains.kp == 0.6f);
+    pid_schedule(&pid, -9999.0f);
+    SIM_CHECK(pid.gains.kp == 0.8f);
+
+    pid_schedule(&pid, 500.0f);
+    for (int i = 0; i < 200; i++)
+        pid_update(&pid, 500.0f, DT);
+
+    float i_before = pid.integral;
+
+    pid_schedule(&pid, 2500.0f);        // ki = 0: integral dipertahankan
+    float out = pid_update(&pid, 2500.0f, DT);
+
+    printf("sched       integral %8.3f out %8.3f\n", i_before, out);
+    SIM_CHECK(near(pid.integral, i_before, 1e-3f));
+    SIM_CHECK(near(out, 0.8f * 2500.0f + i_before, 1e-2f));
+}
+
+int main(void)
+{
+    test_step();
+    test_ramp();
+    test_windup();
+    test_d_filter();
+    test_schedule();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,145 @@
+/* =========================================================
+ *  TEST: qtr_read_raw() via dedicated GPIO bundle (polling cycle counter)
+ *  Tiap pin QTR diberi waktu discharge RC, hasil baca harus
+ *  sama dengan waktu itu (resolusi 1 us), channel gelap = timeout.
+ *  Laporan sampel/detik bundle vs gpio_get_level (biaya baca shim).
+ * ========================================================= */
+#include <stdio.h>
+
+#include "sim.h"
+#include "qtr.h"
+#include "driver/dedic_gpio.h"
+
+#define TIMEOUT_US  3000
+
+static const int pins[QTR_SENSOR_COUNT] = { 38, 39, 1, 2, 3, 4, 5, 6 };
+
+static void set_decays(const int64_t *us)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        sim_gpio_set_decay(pins[i], us[i] < 0 ? -1 : us[i] * 1000);
+}
+
+/* sampel channel & waktu baca, dijumlah per mode */
+static struct {
+    uint64_t samples;
+    int64_t  ns;
+} rate;
+
+static uint32_t channel_samples(void)
+{
+    // 1 baca bundle = 8 channel, 1 gpio_get_level = 1 channel
+    return sim_dedic_reads() * QTR_SENSOR_COUNT + sim_gpio_reads();
+}
+
+/* return durasi baca (us) */
+static int64_t read_frame(uint32_t *v)
+{
+    uint32_t s0 = channel_samples();
+    int64_t  t0 = sim_now_ns();
+
+    SIM_CHECK(qtr_read_raw(v));
+
+    rate.samples += channel_samples() - s0;
+    rate.ns      += sim_now_ns() - t0;
+    return (sim_now_ns() - t0) / 1000;
+}
+
+static void check_frame(const char *name, const int64_t *decay_us)
+{
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    set_decays(decay_us);
+    int64_t took = read_frame(v);
+
+    int64_t max_us = 0;
+    bool    dark   = false;
+
+    printf("%-22s", name);
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        printf(" %4u", (unsigned)v[i]);
+
+        if (decay_us[i] < 0 || decay_us[i] >= TIMEOUT_US)
+        {
+            dark = true;
+            SIM_CHECK(v[i] == TIMEOUT_US);
+            continue;
+        }
+
+        int64_t err = (int64_t)v[i] - decay_us[i];
+        SIM_CHECK(err >= -1 && err <= 1);
+        if (decay_us[i] > max_us)
+            max_us = decay_us[i];
+    }
+    printf("   baca %lld us\n", (long long)took);
+
+    // selesai begitu semua channel turun, atau tepat di timeout
+    if (dark)
+        SIM_CHECK(took >= TIMEOUT_US && took <= TIMEOUT_US + 15);
+    else
+        SIM_CHECK(took <= max_us + 15);
+}
+
+/* return sampel channel per detik selama frame */
+static double run_frames(void)
+{
+    static const int64_t line_mid[QTR_SENSOR_COUNT] =
+        { 180, 190, 240, 900, 1500, 260, 200, 185 };
+    static const int64_t one_dark[QTR_SENSOR_COUNT] =
+        { 180, 190, 200, 210, -1, 230, 240, 250 };
+    static const int64_t same_time[QTR_SENSOR_COUNT] =
+        { 500, 500, 500, 500, 500, 500, 500, 500 };
+    static const int64_t all_dark[QTR_SENSOR_COUNT] =
+        { -1, -1, -1, -1, -1, -1, -1, -1 };
+
+    check_frame("garis di tengah", line_mid);
+    check_frame("1 channel gelap", one_dark);
+    check_frame("serentak 500 us", same_time);
+    check_frame("gelap semua", all_dark);
+
+    double per_s = rate.ns ? rate.samples * 1e9 / rate.ns : 0.0;
+    printf("%-22s %.2f M sampel channel/s, 8 channel tiap %.0f ns (biaya shim)\n",
+           "laju", per_s / 1e6, per_s ? QTR_SENSOR_COUNT * 1e9 / per_s : 0.0);
+
+    rate.samples = 0;
+    rate.ns      = 0;
+    return per_s;
+}
+
+int main(void)
+{
+    sim_reset();
+
+    printf("== bundle (dedicated GPIO) ==\n");
+    qtr_init();
+    SIM_CHECK(sim_dedic_bundles() == 1);
+    double bundle_rate = run_frames();
+
+    // hasil identik: 1 baca bundle = 8 channel pada saat yang sama
+    static const int64_t skew[QTR_SENSOR_COUNT] =
+        { 700, 700, 700, 700, 700, 700, 700, 700 };
+    uint32_t v[QTR_SENSOR_COUNT];
+    set_decays(skew);
+    read_frame(v);
+    for (int i = 1; i < QTR_SENSOR_COUNT; i++)
+        SIM_CHECK(v[i] == v[0]);
+
+    printf("== fallback gpio_get_level (bundle gagal) ==\n");
+    sim_dedic_fail = 1;
+    qtr_init();
+    SIM_CHECK(sim_dedic_bundles() == 0);
+    double gpio_rate = run_frames();
+
+    printf("bundle / gpio_get_level: %.1fx sampel/s\n", bundle_rate / gpio_rate);
+    SIM_CHECK(bundle_rate > gpio_rate);
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
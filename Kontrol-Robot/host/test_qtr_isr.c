@@ -0,0 +1,228 @@
+/* =========================================================
+ *  TEST: simulator edge untuk qtr_read_start()/qtr_read_wait()
+ *  Falling edge tiap pin dijadwalkan di jam virtual, ISR
+ *  memberi timestamp, esp_timer one-shot menutup channel gelap.
+ * ========================================================= */
+#include <stdio.h>
+
+#include "sim.h"
+#include "freertos/FreeRTOS.h"
+#include "qtr.h"
+
+#define TIMEOUT_US  3000
+
+static const int pins[QTR_SENSOR_COUNT] = { 38, 39, 1, 2, 3, 4, 5, 6 };
+
+static void set_decays(const int64_t *us)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        sim_gpio_set_decay(pins[i], us[i] < 0 ? -1 : us[i] * 1000);
+}
+
+static void check_values(const uint32_t *v, const int64_t *decay_us)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        if (decay_us[i] < 0)
+        {
+            SIM_CHECK(v[i] == TIMEOUT_US);
+            continue;
+        }
+
+        int64_t err = (int64_t)v[i] - decay_us[i];
+        SIM_CHECK(err >= -1 && err <= 1);
+    }
+}
+
+static void print_frame(const char *name, const uint32_t *v, int64_t took_us,
+                        uint32_t reads)
+{
+    printf("%-24s", name);
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        printf(" %4u", (unsigned)v[i]);
+    printf("   %lld us, %u gpio read\n", (long long)took_us, (unsigned)reads);
+}
+
+/* frame blocking biasa: task tidur sampai edge terakhir */
+static void test_blocking(const char *name, const int64_t *decay_us)
+{
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    set_decays(decay_us);
+
+    uint32_t reads0 = sim_gpio_reads();
+    int64_t  t0     = sim_now_ns();
+
+    SIM_CHECK(qtr_read_raw(v));
+
+    int64_t  took  = (sim_now_ns() - t0) / 1000;
+    uint32_t reads = sim_gpio_reads() - reads0;
+
+    print_frame(name, v, took, reads);
+    check_values(v, decay_us);
+
+    // tanpa spin: hanya cek edge terlewat (1x per channel)
+    SIM_CHECK(reads <= QTR_SENSOR_COUNT);
+
+    int64_t last = 0;
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        int64_t t = decay_us[i] < 0 ? TIMEOUT_US : decay_us[i];
+        if (t > last)
+            last = t;
+    }
+    SIM_CHECK(took >= last && took <= last + 12);
+}
+
+/* start, kerja lain, lalu ambil frame: tidak menunggu lagi */
+static void test_non_blocking(void)
+{
+    static const int64_t d[QTR_SENSOR_COUNT] =
+        { 300, 320, 400, 1200, 800, 350, 310, 305 };
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    set_decays(d);
+
+    qtr_read_start();
+    sim_advance(5000000);          // 5 ms kerja lain
+
+    int64_t t0 = sim_now_ns();
+    SIM_CHECK(qtr_read_wait(v, 5));
+    SIM_CHECK(sim_now_ns() == t0);
+
+    print_frame("non-blocking", v, 0, 0);
+    check_values(v, d);
+}
+
+/* channel sudah LOW sebelum interrupt aktif: ditangkap saat start */
+static void test_missed_edge(void)
+{
+    static const int64_t d[QTR_SENSOR_COUNT] =
+        { 0, 0, 250, 260, 270, 280, 290, 0 };
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    set_decays(d);
+    SIM_CHECK(qtr_read_raw(v));
+
+    print_frame("edge sebelum enable", v, 0, 0);
+    check_values(v, d);
+}
+
+/* frame lama tidak diambil: start berikutnya membuang sisanya */
+static void test_restart(void)
+{
+    static const int64_t a[QTR_SENSOR_COUNT] =
+        { 100, 100, 100, 100, 100, 100, 100, 100 };
+    static const int64_t b[QTR_SENSOR_COUNT] =
+        { 600, 610, 620, 630, 640, 650, 660, 670 };
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    set_decays(a);
+    qtr_read_start();
+    sim_advance(200000);
+
+    set_decays(b);
+    qtr_read_start();
+    SIM_CHECK(qtr_read_wait(v, 5));
+
+    print_frame("restart frame", v, 0, 0);
+    check_values(v, b);
+}
+
+/* edge dari luar setelah frame selesai: interrupt sudah mati */
+static void test_late_edge(void)
+{
+    static const int64_t d[QTR_SENSOR_COUNT] =
+        { 200, 200, 200, 200, 200, 200, 200, 200 };
+    uint32_t v[QTR_SENSOR_COUNT];
+    uint32_t again[QTR_SENSOR_COUNT];
+
+    set_decays(d);
+    SIM_CHECK(qtr_read_raw(v));
+
+    sim_gpio_drive(pins[3], 1);
+    sim_advance(10000);
+    sim_gpio_drive(pins[3], 0);
+    sim_advance(10000);
+
+    // tidak ada frame baru yang diserahkan
+    SIM_CHECK(!qtr_read_wait(again, 1));
+}
+
+/* tick 100 Hz (sdkconfig default): pdMS_TO_TICKS(4) = 0. Frame dimulai
+ * sesaat sebelum interrupt tick: blok 1 tick berakhir sebelum frame selesai */
+static void test_coarse_tick(const char *name, const int64_t *decay_us)
+{
+    static const int64_t before_tick_us[] = { 10, 500, 2999, 9990 };
+    const int64_t tick_ns = 10000000;
+    uint32_t v[QTR_SENSOR_COUNT];
+
+    sim_tick_hz = 100;
+    set_decays(decay_us);
+
+    int64_t last = 0;
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        int64_t t = decay_us[i] < 0 ? TIMEOUT_US : decay_us[i];
+        if (t > last)
+            last = t;
+    }
+
+    for (int k = 0; k < 4; k++)
+    {
+        sim_advance(tick_ns - sim_now_ns() % tick_ns - before_tick_us[k] * 1000);
+
+        for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+            v[i] = 0;
+
+        int64_t t0 = sim_now_ns();
+        bool    ok = qtr_read_raw(v);
+        int64_t took = (sim_now_ns() - t0) / 1000;
+
+        if (k == 0)
+            print_frame(name, v, took, 0);
+
+        SIM_CHECK(ok);
+        check_values(v, decay_us);
+
+        // selesai di edge terakhir, bukan di tick berikutnya
+        SIM_CHECK(took >= last && took <= last + 12);
+    }
+
+    sim_tick_hz = 1000;
+}
+
+int main(void)
+{
+    static const int64_t line_mid[QTR_SENSOR_COUNT] =
+        { 180, 190, 240, 900, 1500, 260, 200, 185 };
+    static const int64_t one_dark[QTR_SENSOR_COUNT] =
+        { 180, 190, 200, 210, -1, 230, 240, 250 };
+    static const int64_t all_dark[QTR_SENSOR_COUNT] =
+        { -1, -1, -1, -1, -1, -1, -1, -1 };
+
+    sim_reset();
+    qtr_init();
+
+    // ISR capture: bundle dedicated GPIO tidak dialokasikan
+    SIM_CHECK(sim_dedic_bundles() == 0);
+
+    test_blocking("garis di tengah", line_mid);
+    test_blocking("1 channel gelap", one_dark);
+    test_blocking("gelap semua", all_dark);
+    test_non_blocking();
+    test_missed_edge();
+    test_restart();
+    test_late_edge();
+    test_coarse_tick("tick 100 Hz, garis", line_mid);
+    test_coarse_tick("tick 100 Hz, gelap", all_dark);
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
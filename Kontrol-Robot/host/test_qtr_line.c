@@ -0,0 +1,205 @@
+/* =========================================================
+ *  TEST: qtr_estimate_line() dengan frame terkalibrasi 0..1000
+ *  Kasus tetap, lalu tabel frame sintetis (posisi garis diketahui)
+ *  dibandingkan dengan centroid berbobot lama: error posisi & ns/call.
+ * ========================================================= */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+
+#include "sim.h"
+#include "qtr.h"
+
+typedef struct {
+    const char *name;
+    uint16_t    v[QTR_SENSOR_COUNT];
+    bool        found;
+    int         pos_min, pos_max;
+    bool        low_conf;
+} line_case_t;
+
+static const line_case_t cases[] = {
+    { "putih semua",     {   0,   0,   0,    0,    0,   0,   0,   0 }, false,   -1,   -1, true  },
+    { "gelap merata",    {1000,1000,1000, 1000, 1000,1000,1000,1000 }, true,  3500, 3500, true  },
+    { "gelap + noise",   { 950,1000, 980,  990,  970,1000, 960, 990 }, true,  3500, 3500, true  },
+    { "tepat sensor 2",  {  20, 400,1000,  400,   20,  10,  10,  10 }, true,  2000, 2000, false },
+    { "antara 3 dan 4",  {  10,  10,  50,  900,  900,  50,  10,  10 }, true,  3450, 3550, false },
+    { "condong ke 5",    {  10,  10,  10,  100,  700, 900, 300,  10 }, true,  4600, 5000, false },
+    { "ujung kiri",      {1000, 500,  20,   10,   10,  10,  10,  10 }, true,     0,  300, false },
+    { "ujung kanan",     {  10,  10,  10,   10,   10,  20, 500,1000 }, true,  6700, 7000, false },
+};
+
+/* ===== CENTROID LAMA (sebelum estimasi peak + parabola) ===== */
+static int centroid_position(const uint16_t *values)
+{
+    uint32_t weighted_sum = 0;
+    uint32_t sum = 0;
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        uint32_t v = values[i];
+        weighted_sum += v * (i * 1000);
+        sum += v;
+    }
+
+    if (sum == 0)
+        return -1;   // garis hilang
+
+    return weighted_sum / sum;
+}
+
+/* ===== TABEL FRAME: garis di x (0..7000) =====
+ * model sensor sama dengan lf_sim.c: selotip 19 mm, pitch 9.525 mm,
+ * aperture 4 mm (fraksi aperture di atas garis) */
+#define STEP          25
+#define N_POS         ((QTR_SENSOR_COUNT - 1) * 1000 / STEP + 1)
+#define PITCH_MM      9.525
+#define TAPE_W_MM     19.0
+#define APERTURE_MM   4.0
+
+static double darkness(double dist_mm)
+{
+    double v = (TAPE_W_MM / 2.0 + APERTURE_MM / 2.0 - dist_mm) / APERTURE_MM;
+
+    if (v < 0.0) return 0.0;
+    if (v > 1.0) return 1.0;
+    return v;
+}
+
+typedef struct {
+    const char *name;
+    int bg;                  // lantai tidak putih penuh
+    int noise;               // +- per channel
+} frame_set_t;
+
+static uint16_t frames[N_POS][QTR_SENSOR_COUNT];
+static uint32_t rng = 12345;
+
+static int rnd(int n)
+{
+    rng = rng * 1664525u + 1013904223u;
+    return (int)((rng >> 8) % (uint32_t)n);
+}
+
+static void make_frames(const frame_set_t *fs)
+{
+    for (int k = 0; k < N_POS; k++)
+    {
+        double x = k * STEP;
+
+        for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        {
+            double d = fabs(i * 1000 - x) / 1000.0 * PITCH_MM;
+            int v = fs->bg + (int)((QTR_CAL_MAX - fs->bg) * darkness(d));
+
+            if (fs->noise)
+                v += rnd(2 * fs->noise + 1) - fs->noise;
+            if (v < 0)           v = 0;
+            if (v > QTR_CAL_MAX) v = QTR_CAL_MAX;
+            frames[k][i] = (uint16_t)v;
+        }
+    }
+}
+
+typedef struct {
+    double err_avg;
+    int    err_max;
+    double ns_call;
+} est_stat_t;
+
+static int new_position(const uint16_t *v)
+{
+    qtr_line_t line;
+    qtr_estimate_line(v, &line);
+    return line.position;
+}
+
+static volatile int sink;
+
+static est_stat_t measure(int (*est)(const uint16_t *))
+{
+    est_stat_t st = { 0 };
+    long sum = 0;
+
+    for (int k = 0; k < N_POS; k++)
+    {
+        int err = abs(est(frames[k]) - k * STEP);
+        sum += err;
+        if (err > st.err_max)
+            st.err_max = err;
+    }
+    st.err_avg = (double)sum / N_POS;
+
+    // waktu host, bukan cycle ESP32: hanya perbandingan relatif
+    const int reps = 2000;
+    struct timespec t0, t1;
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    for (int r = 0; r < reps; r++)
+        for (int k = 0; k < N_POS; k++)
+            sink += est(frames[k]);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    double ns = (t1.tv_sec - t0.tv_sec) * 1e9 + (t1.tv_nsec - t0.tv_nsec);
+    st.ns_call = ns / ((double)reps * N_POS);
+    return st;
+}
+
+static void compare_centroid(void)
+{
+    static const frame_set_t sets[] = {
+        { "lantai putih",      0,  0 },
+        { "lantai bg 150",   150,  0 },
+        { "bg 150 + noise",  150, 40 },
+    };
+
+    printf("\n== vs centroid lama, %d posisi 0..7000 ==\n", N_POS);
+    printf("%-16s %-9s %8s %8s %8s\n", "frame", "estimasi", "err rata", "err maks", "ns/call");
+
+    for (unsigned s = 0; s < sizeof(sets) / sizeof(sets[0]); s++)
+    {
+        make_frames(&sets[s]);
+
+        est_stat_t c = measure(centroid_position);
+        est_stat_t n = measure(new_position);
+
+        printf("%-16s %-9s %8.1f %8d %8.1f\n", sets[s].name, "centroid",
+               c.err_avg, c.err_max, c.ns_call);
+        printf("%-16s %-9s %8.1f %8d %8.1f\n", "", "peak+fit",
+               n.err_avg, n.err_max, n.ns_call);
+
+        // lebih akurat di semua set; centroid ditarik background ke tengah
+        SIM_CHECK(n.err_avg < c.err_avg);
+        SIM_CHECK(n.err_max < c.err_max);
+    }
+}
+
+int main(void)
+{
+    for (unsigned i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+    {
+        const line_case_t *c = &cases[i];
+        qtr_line_t line;
+
+        bool found = qtr_estimate_line(c->v, &line);
+
+        printf("%-16s found=%d pos=%5d conf=%4d\n",
+               c->name, found, line.position, line.confidence);
+
+        SIM_CHECK(found == c->found);
+        SIM_CHECK(line.position >= c->pos_min && line.position <= c->pos_max);
+        SIM_CHECK((line.confidence < QTR_MIN_CONFIDENCE) == c->low_conf);
+    }
+
+    compare_centroid();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
@@ -0,0 +1,269 @@
+/* =========================================================
+ *  TEST: antrian event MPSC robot_state.c dengan pthread
+ *  Beberapa produsen robot_event_post() bersamaan, satu konsumen
+ *  (peran robot_state_task). Tidak ada event hilang / dobel,
+ *  urutan per produsen tetap, tidak ada notifikasi yang hilang
+ *  walau produsen mulai sebelum owner terpasang. Plus tabel transisi
+ *  (termasuk EV_RESUME, satu-satunya jalan keluar ERROR selain reboot).
+ *  Tanpa jam virtual: notifikasi task ditiru dengan mutex + condvar.
+ * ========================================================= */
+#include <stdio.h>
+#include <pthread.h>
+#include <sched.h>
+#include <time.h>
+
+#include "sim.h"
+
+/* evq, owner, transition() bersifat static */
+#include "../main/robot_state.c"
+
+/* ===== STUB NOTIFIKASI TASK ===== */
+struct sim_task {
+    pthread_mutex_t lock;
+    pthread_cond_t  cond;
+    unsigned        count;
+};
+
+#define STALL_MS  2000      // tidur selama ini dengan event tertunda = notifikasi hilang
+
+static struct sim_task consumer_task = {
+    PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, 0
+};
+static _Thread_local TaskHandle_t cur_task;
+static atomic_uint notify_n;
+static atomic_uint stall_n;
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void)
+{
+    return cur_task;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t)
+{
+    pthread_mutex_lock(&t->lock);
+    t->count++;
+    pthread_cond_signal(&t->cond);
+    pthread_mutex_unlock(&t->lock);
+
+    atomic_fetch_add(&notify_n, 1);
+    return pdPASS;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks)
+{
+    struct sim_task *t = cur_task;
+    struct timespec  until;
+
+    clock_gettime(CLOCK_REALTIME, &until);
+    until.tv_sec += STALL_MS / 1000;
+
+    pthread_mutex_lock(&t->lock);
+    while (t->count == 0)
+    {
+        if (pthread_cond_timedwait(&t->cond, &t->lock, &until))
+        {
+            atomic_fetch_add(&stall_n, 1);
+            break;
+        }
+    }
+
+    uint32_t n = t->count;
+    if (clear)
+        t->count = 0;
+    else if (n)
+        t->count--;
+    pthread_mutex_unlock(&t->lock);
+
+    (void)ticks;
+    return n;
+}
+
+/* ===== PRODUSEN / KONSUMEN ===== */
+#define PRODUCERS  4
+#define PER_PROD   100000
+#define TOTAL      (PRODUCERS * PER_PROD)
+
+#define ARG(p, i)  ((p) << 24 | (i))
+
+static pthread_barrier_t start;
+
+static struct {
+    unsigned next[PRODUCERS];   // nomor berikut yang diharapkan
+    unsigned bad_order;
+    unsigned bad_event;
+    unsigned got;
+} rx;
+
+static atomic_uint full_n;      // post ditolak: antrian penuh
+
+static void *producer(void *p)
+{
+    int id = (int)(intptr_t)p;
+
+    pthread_barrier_wait(&start);
+
+    for (int i = 0; i < PER_PROD; i++)
+    {
+        // event berbeda per produsen: cek ev + arg tidak tertukar
+        while (!robot_event_post((robot_event_t)(id % EV_COUNT), ARG(id, i)))
+        {
+            atomic_fetch_add(&full_n, 1);
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void consume(robot_event_t ev, int arg)
+{
+    unsigned id = (unsigned)arg >> 24;
+    unsigned i  = (unsigned)arg & 0xFFFFFF;
+
+    if (id >= PRODUCERS || ev != (robot_event_t)(id % EV_COUNT))
+    {
+        rx.bad_event++;
+        return;
+    }
+    if (i != rx.next[id])
+        rx.bad_order++;
+    rx.next[id] = i + 1;
+    rx.got++;
+}
+
+/* peran robot_state_task, berhenti setelah TOTAL event */
+static void *consumer(void *unused)
+{
+    robot_event_t ev;
+    int arg;
+
+    cur_task = &consumer_task;
+    pthread_barrier_wait(&start);
+
+    atomic_store(&owner, xTaskGetCurrentTaskHandle());
+
+    while (rx.got < TOTAL)
+    {
+        while (evq_pop(&ev, &arg))
+            consume(ev, arg);
+
+        if (rx.got < TOTAL && ulTaskNotifyTake(pdTRUE, portMAX_DELAY) == 0)
+            break;      // macet: laporkan, jangan hang
+    }
+    return NULL;
+}
+
+/* ===== TEST ===== */
+static void reset(void)
+{
+    robot_state_init(ROBOT_RUN);
+    atomic_store(&owner, NULL);
+    consumer_task.count = 0;
+}
+
+/* tanpa konsumen: EVQ_LEN masuk, berikutnya ditolak, pop FIFO */
+static void test_full(void)
+{
+    robot_event_t ev;
+    int arg;
+
+    reset();
+
+    for (int i = 0; i < EVQ_LEN; i++)
+        SIM_CHECK(robot_event_post(EV_UPLOAD_DONE, i));
+    SIM_CHECK(!robot_event_post(EV_OBSTACLE, 99));
+
+    for (int i = 0; i < EVQ_LEN; i++)
+        SIM_CHECK(evq_pop(&ev, &arg) && ev == EV_UPLOAD_DONE && arg == i);
+    SIM_CHECK(!evq_pop(&ev, &arg));
+
+    // slot bebas lagi setelah wrap
+    SIM_CHECK(robot_event_post(EV_OBSTACLE, 7));
+    SIM_CHECK(evq_pop(&ev, &arg) && ev == EV_OBSTACLE && arg == 7);
+
+    // belum ada owner: tidak ada notifikasi
+    SIM_CHECK(atomic_load(&notify_n) == 0);
+}
+
+static void test_mpsc(void)
+{
+    pthread_t prod[PRODUCERS], cons;
+
+    reset();
+    atomic_store(&notify_n, 0);
+
+    pthread_barrier_init(&start, NULL, PRODUCERS + 1);
+
+    pthread_create(&cons, NULL, consumer, NULL);
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_create(&prod[i], NULL, producer, (void *)(intptr_t)i);
+
+    for (int i = 0; i < PRODUCERS; i++)
+        pthread_join(prod[i], NULL);
+    pthread_join(cons, NULL);
+    pthread_barrier_destroy(&start);
+
+    printf("mpsc         %d produsen x %d  terima %u  urutan salah %u  event salah %u\n",
+           PRODUCERS, PER_PROD, rx.got, rx.bad_order, rx.bad_event);
+    printf("             penuh %u  notifikasi %u  macet %u\n",
+           atomic_load(&full_n), atomic_load(&notify_n), atomic_load(&stall_n));
+
+    SIM_CHECK(rx.got == TOTAL);
+    SIM_CHECK(rx.bad_order == 0 && rx.bad_event == 0);
+    for (int i = 0; i < PRODUCERS; i++)
+        SIM_CHECK(rx.next[i] == PER_PROD);
+    SIM_CHECK(atomic_load(&stall_n) == 0);
+
+    // antrian kosong setelah semua selesai
+    robot_event_t ev;
+    int arg;
+    SIM_CHECK(!evq_pop(&ev, &arg));
+}
+
+/* tabel transisi lengkap: state x event */
+static void test_transition(void)
+{
+    static const robot_state_t want[3][EV_COUNT] = {
+        /*            OBSTACLE     CAP_DONE     CAP_FAILED   UPLOAD       LINE_LOST    RESUME */
+        [ROBOT_RUN]   = { ROBOT_STOP,  ROBOT_RUN,   ROBOT_RUN,   ROBOT_RUN,   ROBOT_ERROR, ROBOT_RUN  },
+        [ROBOT_STOP]  = { ROBOT_STOP,  ROBOT_RUN,   ROBOT_ERROR, ROBOT_STOP,  ROBOT_STOP,  ROBOT_STOP },
+        [ROBOT_ERROR] = { ROBOT_ERROR, ROBOT_ERROR, ROBOT_ERROR, ROBOT_ERROR, ROBOT_ERROR, ROBOT_RUN  },
+    };
+
+    for (int s = ROBOT_RUN; s <= ROBOT_ERROR; s++)
+    {
+        for (int e = 0; e < EV_COUNT; e++)
+        {
+            robot_state_t got = transition((robot_state_t)s, (robot_event_t)e);
+            if (got != want[s][e])
+                printf("transisi %s + %s -> %s, harus %s\n", state_name[s],
+                       event_name[e], state_name[got], state_name[want[s][e]]);
+            SIM_CHECK(got == want[s][e]);
+        }
+    }
+
+    // siklus pot: RUN -> STOP -> RUN
+    robot_state_init(ROBOT_RUN);
+    SIM_CHECK(robot_state_get() == ROBOT_RUN);
+    SIM_CHECK(transition(transition(ROBOT_RUN, EV_OBSTACLE), EV_CAPTURE_DONE) == ROBOT_RUN);
+
+    // garis hilang lalu resume dari backend: RUN -> ERROR -> RUN
+    SIM_CHECK(transition(transition(ROBOT_RUN, EV_LINE_LOST), EV_RESUME) == ROBOT_RUN);
+}
+
+int main(void)
+{
+    sim_log_level = 0;      // "queue full" dari produsen terlalu ramai
+
+    test_full();
+    test_transition();
+    test_mpsc();
+
+    if (sim_failures())
+    {
+        printf("%d cek gagal\n", sim_failures());
+        return 1;
+    }
+
+    printf("OK\n");
+    return 0;
+}
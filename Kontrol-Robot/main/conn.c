@@ -0,0 +1,183 @@
+#include "conn.h"
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_wifi.h"
+#include "esp_event.h"
+#include "esp_netif.h"
+#include "esp_now.h"
+
+#define TAG "CONN"
+
+#define WIFI_SSID "vivo Y33S"
+#define WIFI_PASS "arduinouno"
+
+#define CONN_MAX_CB     4
+#define CONN_MAX_PEERS  4
+
+static EventGroupHandle_t conn_group;
+
+static struct {
+    conn_cb_t cb;
+    void     *arg;
+} conn_cbs[CONN_MAX_CB];
+static int conn_cb_count = 0;
+
+static uint8_t peers[CONN_MAX_PEERS][ESP_NOW_ETH_ALEN];
+static int     peer_count = 0;
+
+static volatile uint8_t sta_channel = 0;   // 0 = belum associated
+
+/* ================= PUBLISH ================= */
+static void conn_publish(conn_event_t evt)
+{
+    for (int i = 0; i < conn_cb_count; i++)
+        conn_cbs[i].cb(evt, conn_cbs[i].arg);
+}
+
+/* ================= ESP-NOW PEER ================= */
+static void peer_apply(const uint8_t *mac, bool add)
+{
+    esp_now_peer_info_t peer = {0};
+    memcpy(peer.peer_addr, mac, ESP_NOW_ETH_ALEN);
+    peer.channel = sta_channel;
+    peer.ifidx   = WIFI_IF_STA;
+    peer.encrypt = false;
+
+    if (add)
+        esp_now_add_peer(&peer);
+    else
+        esp_now_mod_peer(&peer);
+}
+
+static void conn_set_channel(uint8_t ch)
+{
+    if (ch == sta_channel)
+        return;
+
+    sta_channel = ch;
+
+    for (int i = 0; i < peer_count; i++)
+        peer_apply(peers[i], false);
+
+    ESP_LOGI(TAG, "STA channel %u, %d peer ESP-NOW ikut", ch, peer_count);
+    conn_publish(CONN_EVT_CHANNEL);
+}
+
+/* ================= WIFI HANDLER ================= */
+static void conn_event_handler(void *arg,
+                               esp_event_base_t event_base,
+                               int32_t event_id,
+                               void *event_data)
+{
+    if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START)
+    {
+        esp_wifi_connect();
+    }
+    else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED)
+    {
+        wifi_event_sta_connected_t *ev = event_data;
+
+        xEventGroupSetBits(conn_group, CONN_BIT_LINK);
+        conn_set_channel(ev->channel);
+    }
+    else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED)
+    {
+        EventBits_t was = xEventGroupClearBits(conn_group,
+                                               CONN_BIT_LINK | CONN_BIT_IP);
+        if (was & CONN_BIT_LINK)
+        {
+            ESP_LOGW(TAG, "WiFi disconnected");
+            conn_publish(CONN_EVT_DOWN);
+        }
+
+        esp_wifi_connect();
+    }
+    else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP)
+    {
+        ESP_LOGI(TAG, "WiFi connected");
+        xEventGroupSetBits(conn_group, CONN_BIT_IP);
+        conn_publish(CONN_EVT_UP);
+    }
+}
+
+/* ================= INIT ================= */
+void conn_init(void)
+{
+    conn_group = xEventGroupCreate();
+
+    ESP_ERROR_CHECK(esp_netif_init());
+    ESP_ERROR_CHECK(esp_event_loop_create_default());
+    esp_netif_create_default_wifi_sta();
+
+    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
+    ESP_ERROR_CHECK(esp_wifi_init(&cfg));
+
+    esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
+                               &conn_event_handler, NULL);
+    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
+                               &conn_event_handler, NULL);
+
+    wifi_config_t wifi_cfg = {
+        .sta = {
+            .ssid = WIFI_SSID,
+            .password = WIFI_PASS,
+        }
+    };
+
+    esp_wifi_set_mode(WIFI_MODE_STA);
+    esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg);
+    ESP_ERROR_CHECK(esp_wifi_start());
+
+    esp_wifi_set_ps(WIFI_PS_NONE);   // ESP-NOW tidak tertunda modem sleep
+
+    ESP_ERROR_CHECK(esp_now_init());
+
+    ESP_LOGI(TAG, "Radio ready");
+}
+
+/* ================= API ================= */
+bool conn_is_up(void)
+{
+    return (xEventGroupGetBits(conn_group) & CONN_BIT_IP) != 0;
+}
+
+bool conn_wait_up(TickType_t timeout)
+{
+    EventBits_t bits = xEventGroupWaitBits(conn_group, CONN_BIT_IP,
+                                           pdFALSE, pdTRUE, timeout);
+    return (bits & CONN_BIT_IP) != 0;
+}
+
+EventGroupHandle_t conn_events(void)
+{
+    return conn_group;
+}
+
+uint8_t conn_channel(void)
+{
+    return sta_channel;
+}
+
+esp_err_t conn_register_cb(conn_cb_t cb, void *arg)
+{
+    if (conn_cb_count >= CONN_MAX_CB)
+        return ESP_ERR_NO_MEM;
+
+    conn_cbs[conn_cb_count].cb  = cb;
+    conn_cbs[conn_cb_count].arg = arg;
+    conn_cb_count++;
+    return ESP_OK;
+}
+
+esp_err_t conn_espnow_add_peer(const uint8_t *mac)
+{
+    if (peer_count >= CONN_MAX_PEERS)
+        return ESP_ERR_NO_MEM;
+
+    memcpy(peers[peer_count], mac, ESP_NOW_ETH_ALEN);
+    peer_count++;
+
+    peer_apply(mac, true);
+    return ESP_OK;
+}
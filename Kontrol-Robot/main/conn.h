@@ -0,0 +1,41 @@
+#ifndef CONN_H
+#define CONN_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/event_groups.h"
+
+/* =========================================================
+ *  KONEKTIVITAS: satu-satunya pemilik WiFi / ESP-NOW / event loop
+ * ========================================================= */
+
+/* ===== EVENT GROUP BITS ===== */
+#define CONN_BIT_LINK   BIT0    // STA associated ke AP
+#define CONN_BIT_IP     BIT1    // sudah dapat IP
+
+typedef enum {
+    CONN_EVT_UP = 0,     // dapat IP
+    CONN_EVT_DOWN,       // putus dari AP
+    CONN_EVT_CHANNEL     // channel STA berubah (peer ESP-NOW sudah diikutkan)
+} conn_event_t;
+
+/* dipanggil dari task event loop, harus singkat */
+typedef void (*conn_cb_t)(conn_event_t evt, void *arg);
+
+/* sekali di app_main, sebelum task lain dibuat */
+void conn_init(void);
+
+bool               conn_is_up(void);
+bool               conn_wait_up(TickType_t timeout);
+EventGroupHandle_t conn_events(void);
+uint8_t            conn_channel(void);
+
+esp_err_t conn_register_cb(conn_cb_t cb, void *arg);
+
+/* peer ESP-NOW selalu di channel STA */
+esp_err_t conn_espnow_add_peer(const uint8_t *mac);
+
+#endif
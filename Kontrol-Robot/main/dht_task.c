@@ -1,7 +1,6 @@
 #include <stdio.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
 #include "esp_log.h"
 #include "driver/gpio.h"
 
@@ -13,8 +12,6 @@
 #define DHT_PIN     GPIO_NUM_11
 #define DHT_TYPE    DHT_TYPE_AM2301   // DHT22
 
-extern QueueHandle_t dht_queue;
-
 void dht_task(void *pv)
 {
     dht_data_t data;
@@ -57,7 +54,7 @@ void dht_task(void *pv)
             ESP_LOGI(TAG, "Temp=%.2f°C Hum=%.2f%%",
                      data.temperature, data.humidity);
 
-            xQueueSend(dht_queue, &data, 0);
+            wifi_http_post_dht(&data);
         }
         else
         {
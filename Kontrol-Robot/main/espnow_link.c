@@ -0,0 +1,158 @@
+#include "espnow_link.h"
+#include <string.h>
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_now.h"
+#include "esp_random.h"
+
+#include "conn.h"
+
+static const char *TAG = "ESPNOW";
+
+static uint8_t CAM_MAC[6] = { 0x24, 0x6F, 0x28, 0xAA, 0xBB, 0xCC }; // GANTI!
+
+static QueueHandle_t rx_queue;     // espnow_msg_t dari kamera
+static QueueHandle_t tx_queue;     // status kirim terakhir
+
+/* seq mulai acak: setelah reboot tidak mengulang seq yang masih diingat kamera */
+static uint16_t tx_seq     = 0;
+static uint32_t boot_nonce = 0;
+
+/* =========================================================
+ *  CALLBACK (task WiFi)
+ * ========================================================= */
+static void espnow_recv_cb(const esp_now_recv_info_t *info,
+                           const uint8_t *data, int len)
+{
+    if (len != sizeof(espnow_msg_t))
+        return;
+    if (memcmp(info->src_addr, CAM_MAC, 6) != 0)
+        return;
+
+    espnow_msg_t msg;
+    memcpy(&msg, data, sizeof(msg));
+
+    if (msg.ver != ESPNOW_PROTO_VER)
+        return;
+
+    xQueueSend(rx_queue, &msg, 0);
+}
+
+static void espnow_send_cb(const uint8_t *mac, esp_now_send_status_t status)
+{
+    xQueueOverwrite(tx_queue, &status);
+}
+
+/* =========================================================
+ *  INIT
+ * ========================================================= */
+void espnow_link_init(void)
+{
+    rx_queue = xQueueCreate(4, sizeof(espnow_msg_t));
+    tx_queue = xQueueCreate(1, sizeof(esp_now_send_status_t));
+
+    // RNG hardware: acak sejak radio aktif (conn.c)
+    boot_nonce = esp_random();
+    tx_seq     = (uint16_t)esp_random();
+
+    // radio & esp_now_init() dimiliki conn.c
+    esp_now_register_recv_cb(espnow_recv_cb);
+    esp_now_register_send_cb(espnow_send_cb);
+
+    conn_espnow_add_peer(CAM_MAC);
+
+    ESP_LOGI(TAG, "ESP-NOW ready");
+}
+
+/* =========================================================
+ *  KIRIM 1x + tunggu status MAC layer
+ * ========================================================= */
+static bool espnow_send_msg(const espnow_msg_t *msg)
+{
+    esp_now_send_status_t status;
+
+    xQueueReceive(tx_queue, &status, 0);   // buang status lama
+
+    if (esp_now_send(CAM_MAC, (const uint8_t *)msg, sizeof(*msg)) != ESP_OK)
+        return false;
+
+    if (!xQueueReceive(tx_queue, &status, pdMS_TO_TICKS(ESPNOW_ACK_TIMEOUT_MS)))
+        return false;
+
+    return status == ESP_NOW_SEND_SUCCESS;
+}
+
+/* =========================================================
+ *  CAPTURE: seq baru, retransmit sampai DONE / batas waktu
+ *  DONE/ACK dengan seq / nonce lain (duplikat lama) diabaikan
+ * ========================================================= */
+bool espnow_link_capture(uint16_t pot)
+{
+    espnow_msg_t msg = {
+        .ver   = ESPNOW_PROTO_VER,
+        .cmd   = CMD_TAKE_PICTURE,
+        .seq   = ++tx_seq,
+        .nonce = boot_nonce,
+        .pot   = pot,
+    };
+    espnow_msg_t rx;
+
+    int64_t deadline = esp_timer_get_time() +
+                       (int64_t)ESPNOW_CAPTURE_MAX_MS * 1000;
+    int tries = 0;
+
+    xQueueReset(rx_queue);
+
+    while (esp_timer_get_time() < deadline)
+    {
+        tries++;
+
+        if (!espnow_send_msg(&msg))
+        {
+            ESP_LOGW(TAG, "seq %u: kirim gagal (try %d)", msg.seq, tries);
+            vTaskDelay(pdMS_TO_TICKS(ESPNOW_ACK_TIMEOUT_MS));
+            continue;
+        }
+
+        // tunggu ACK dulu (cepat), lalu DONE (lama)
+        uint32_t wait_ms = ESPNOW_ACK_TIMEOUT_MS;
+
+        while (1)
+        {
+            int64_t left_ms = (deadline - esp_timer_get_time()) / 1000;
+            if (left_ms <= 0)
+                break;
+            if (wait_ms > left_ms)
+                wait_ms = (uint32_t)left_ms;
+
+            if (!xQueueReceive(rx_queue, &rx, pdMS_TO_TICKS(wait_ms) + 1))
+                break;
+
+            if (rx.seq != msg.seq || rx.nonce != msg.nonce)
+                continue;
+
+            if (rx.cmd == CMD_ACK)
+            {
+                wait_ms = ESPNOW_DONE_TIMEOUT_MS;
+                continue;
+            }
+
+            if (rx.cmd == CMD_DONE)
+            {
+                ESP_LOGI(TAG, "seq %u: DONE pot %u status %u (try %d)",
+                         msg.seq, rx.pot, rx.status, tries);
+                return rx.status == 0;
+            }
+        }
+
+        ESP_LOGW(TAG, "seq %u: timeout, kirim ulang", msg.seq);
+    }
+
+    ESP_LOGE(TAG, "seq %u: kamera tidak merespon (%d try)", msg.seq, tries);
+    return false;
+}
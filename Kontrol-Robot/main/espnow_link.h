@@ -0,0 +1,42 @@
+#ifndef ESPNOW_LINK_H
+#define ESPNOW_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* =========================================================
+ *  PROTOKOL ROBOT <-> ESP32-CAM
+ *  Harus sama dengan firmware kamera (Testing Code/main.c)
+ * ========================================================= */
+#define ESPNOW_PROTO_VER   2
+
+typedef enum {
+    CMD_NONE = 0,
+    CMD_TAKE_PICTURE,   // robot -> cam
+    CMD_DONE,           // cam -> robot, status di .status
+    CMD_ACK             // cam -> robot, perintah diterima
+} cmd_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  ver;
+    uint8_t  cmd;
+    uint16_t seq;       // naik per perintah baru, sama saat retransmit
+    uint32_t nonce;     // acak per boot robot; kamera dedup per (MAC, nonce, seq)
+    uint16_t pot;
+    uint8_t  status;    // CMD_DONE: 0 = OK
+} espnow_msg_t;
+
+/* ===== CONFIG ===== */
+#define ESPNOW_ACK_TIMEOUT_MS    250    // tunggu ACK/DONE sebelum kirim ulang
+#define ESPNOW_DONE_TIMEOUT_MS   4000   // tunggu DONE setelah ACK
+#define ESPNOW_CAPTURE_MAX_MS    10000  // batas total, lalu gagal
+
+void espnow_link_init(void);
+
+/*
+ * Kirim TAKE_PICTURE untuk pot, retransmit sampai DONE.
+ * Blocking maks ESPNOW_CAPTURE_MAX_MS. true = kamera sudah capture.
+ */
+bool espnow_link_capture(uint16_t pot);
+
+#endif
@@ -1,6 +1,5 @@
 #include "hcsr.h"
 #include "robot_state.h"
-#include <string.h>
 
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -10,9 +9,8 @@
 #include "esp_rom_sys.h"
 #include "esp_log.h"
 
-#include "esp_wifi.h"
-#include "esp_now.h"
-#include "esp_netif.h"
+#include "espnow_link.h"
+#include "wifi_http.h"
 
 /* ===== PIN CONFIG ===== */
 #define TRIG_PIN GPIO_NUM_12
@@ -20,78 +18,69 @@
 
 /* ===== PARAM ===== */
 #define TIMEOUT_US         30000
-#define STOP_CM            5
-#define DETECT_CONFIRM     3
+#define STOP_CM            HCSR_STOP_CM
 #define LOG_INTERVAL_US    1000000
 
+/* ===== SAMPLING & FILTER ===== */
+#define SAMPLE_MS_MOVING   60     // HC-SR04 butuh ~60 ms antar ping
+#define SAMPLE_MS_IDLE     200
+#define MEDIAN_N           3
+#define FAR_CM             400    // timeout echo = tidak ada objek
+
+/* Keputusan stop: akumulasi confidence 0..CONF_MAX */
+#define CONF_MAX           100
+#define CONF_STOP          100
+#define CONF_HIT           25     // butuh 4 median berturut < STOP_CM
+#define CONF_MISS          35
+#define REARM_CM           (STOP_CM + 5)  // pot lama harus lewat dulu
+#define REARM_SAMPLES      5      // berturut, echo hilang sesaat tidak me-rearm
+
 static const char *TAG = "HCSR";
 
 /* ===== EXTERNAL ===== */
 extern SemaphoreHandle_t log_mutex;
 
-/* ===== ESPNOW ===== */
-static uint8_t CAM_MAC[6] = { 0x24, 0x6F, 0x28, 0xAA, 0xBB, 0xCC }; // GANTI!
-
-typedef enum {
-    CMD_NONE = 0,
-    CMD_TAKE_PICTURE,
-    CMD_DONE
-} cmd_t;
-
-typedef struct {
-    uint8_t  cmd;
-    uint16_t pot;
-} espnow_msg_t;
-
-static SemaphoreHandle_t done_sem;
+/* ===== ECHO CAPTURE (ISR) ===== */
+static volatile TaskHandle_t echo_waiter = NULL;
+static volatile int64_t      echo_rise   = 0;
 
 /* ===== INTERNAL ===== */
-static int last_state   = ROBOT_RUN;
 static int pot_counter  = 1;
-static int detect_count = 0;
 
-/* =========================================================
- *  ESPNOW CALLBACK
- * ========================================================= */
-static void espnow_recv_cb(const esp_now_recv_info_t *info,
-                           const uint8_t *data, int len)
-{
-    if (len != sizeof(espnow_msg_t)) return;
-
-    espnow_msg_t msg;
-    memcpy(&msg, data, sizeof(msg));
+/* ===== FILTER ===== */
+static int  hist[MEDIAN_N];
+static int  hist_n     = 0;
+static int  hist_idx   = 0;
+static int  confidence = 0;
+static bool armed      = true;
+static int  rearm_n    = 0;
 
-    if (msg.cmd == CMD_DONE) {
-        ESP_LOGI(TAG, "DONE received from CAM");
-        xSemaphoreGive(done_sem);
-    }
-}
+static volatile int filtered_cm = -1;
 
 /* =========================================================
- *  ESPNOW INIT
+ *  ECHO ISR: rising = mulai, falling = lebar pulsa -> notify
  * ========================================================= */
-static void espnow_init(void)
+static void echo_isr(void *arg)
 {
-    esp_netif_init();
-    esp_event_loop_create_default();
+    int64_t now = esp_timer_get_time();
 
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_wifi_init(&cfg);
-    esp_wifi_set_mode(WIFI_MODE_STA);
-    esp_wifi_start();
+    if (gpio_get_level(ECHO_PIN))
+    {
+        echo_rise = now;
+        return;
+    }
 
-    esp_now_init();
-    esp_now_register_recv_cb(espnow_recv_cb);
+    if (echo_rise == 0 || echo_waiter == NULL)
+        return;
 
-    esp_now_peer_info_t peer = {0};
-    memcpy(peer.peer_addr, CAM_MAC, 6);
-    peer.channel = 0;
-    peer.encrypt = false;
-    esp_now_add_peer(&peer);
+    BaseType_t woken = pdFALSE;
+    uint32_t width = (uint32_t)(now - echo_rise);
 
-    done_sem = xSemaphoreCreateBinary();
+    echo_rise = 0;
+    xTaskNotifyFromISR(echo_waiter, width, eSetValueWithOverwrite, &woken);
 
-    ESP_LOGI(TAG, "ESP-NOW ready");
+    if (woken)
+        portYIELD_FROM_ISR(woken);
 }
 
 /* =========================================================
@@ -107,19 +96,31 @@ void hcsr_init(void)
 
     io.pin_bit_mask = 1ULL << ECHO_PIN;
     io.mode = GPIO_MODE_INPUT;
+    io.intr_type = GPIO_INTR_ANYEDGE;
     gpio_config(&io);
 
     gpio_set_level(TRIG_PIN, 0);
 
-    espnow_init();
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+        ESP_LOGE(TAG, "ISR service gagal: %s", esp_err_to_name(err));
+
+    gpio_isr_handler_add(ECHO_PIN, echo_isr, NULL);
+
+    espnow_link_init();
 }
 
 /* =========================================================
- *  JANGAN DIUBAH
+ *  KONTRAK TETAP: cm, -1 = timeout, -2 = di luar 2..400 cm
+ *  Pulsa echo diukur ISR, task menunggu notifikasi (tanpa spin)
  * ========================================================= */
 int hcsr_read_cm(void)
 {
-    int64_t t_start, t_end;
+    uint32_t width;
+
+    echo_rise   = 0;
+    echo_waiter = xTaskGetCurrentTaskHandle();
+    xTaskNotifyStateClear(NULL);
 
     gpio_set_level(TRIG_PIN, 0);
     esp_rom_delay_us(5);
@@ -127,19 +128,16 @@ int hcsr_read_cm(void)
     esp_rom_delay_us(10);
     gpio_set_level(TRIG_PIN, 0);
 
-    int64_t t0 = esp_timer_get_time();
-    while (gpio_get_level(ECHO_PIN) == 0)
-        if (esp_timer_get_time() - t0 > TIMEOUT_US)
-            return -1;
+    // tunggu rising + falling, masing-masing maks TIMEOUT_US
+    BaseType_t got = xTaskNotifyWait(0, UINT32_MAX, &width,
+                                     pdMS_TO_TICKS(2 * TIMEOUT_US / 1000) + 1);
 
-    t_start = esp_timer_get_time();
-    while (gpio_get_level(ECHO_PIN) == 1)
-        if (esp_timer_get_time() - t_start > TIMEOUT_US)
-            return -1;
+    echo_waiter = NULL;
 
-    t_end = esp_timer_get_time();
+    if (got != pdTRUE || width > TIMEOUT_US)
+        return -1;
 
-    int d = (int)((t_end - t_start) / 58);
+    int d = (int)(width / 58);
     if (d < 2 || d > 400) return -2;
 
     return d;
@@ -162,6 +160,81 @@ static void hcsr_log(int d)
 #endif
 }
 
+/* =========================================================
+ *  FILTER: median N sampel + confidence
+ * ========================================================= */
+static int median_push(int d)
+{
+    hist[hist_idx] = d;
+    hist_idx = (hist_idx + 1) % MEDIAN_N;
+    if (hist_n < MEDIAN_N)
+        hist_n++;
+
+    int tmp[MEDIAN_N];
+    for (int i = 0; i < hist_n; i++)
+        tmp[i] = hist[i];
+
+    // insertion sort, N kecil
+    for (int i = 1; i < hist_n; i++)
+    {
+        int v = tmp[i], j = i - 1;
+        while (j >= 0 && tmp[j] > v) {
+            tmp[j + 1] = tmp[j];
+            j--;
+        }
+        tmp[j + 1] = v;
+    }
+
+    return tmp[hist_n / 2];
+}
+
+int hcsr_get_distance_cm(void)
+{
+    return filtered_cm;
+}
+
+static void filter_reset(void)
+{
+    filtered_cm = -1;
+    hist_n     = 0;
+    hist_idx   = 0;
+    confidence = 0;
+    rearm_n    = 0;
+}
+
+/* true = pot terdeteksi dengan confidence cukup */
+static bool detect_update(int d)
+{
+    if (d == -2)            // di luar range (noise), abaikan
+        return false;
+    if (d < 0)              // tanpa echo = jauh
+        d = FAR_CM;
+
+    int med = median_push(d);
+
+    if (!armed)
+    {
+        filtered_cm = -1;
+        if (d < REARM_CM)
+            rearm_n = 0;
+        else if (++rearm_n >= REARM_SAMPLES)
+            armed = true;
+        return false;
+    }
+
+    filtered_cm = (med < FAR_CM) ? med : -1;
+
+    if (med < STOP_CM)
+        confidence += CONF_HIT;
+    else
+        confidence -= CONF_MISS;
+
+    if (confidence < 0)        confidence = 0;
+    if (confidence > CONF_MAX) confidence = CONF_MAX;
+
+    return confidence >= CONF_STOP;
+}
+
 /* =========================================================
  *  TASK
  * ========================================================= */
@@ -175,7 +248,6 @@ void hcsr_task(void *pv)
     while (1)
     {
         int d = hcsr_read_cm();
-        int next_state = ROBOT_RUN;
         int64_t now = esp_timer_get_time();
 
         if (now - last_log > LOG_INTERVAL_US) {
@@ -183,38 +255,35 @@ void hcsr_task(void *pv)
             last_log = now;
         }
 
-        if (d > 0 && d < STOP_CM) {
-            detect_count++;
-            if (detect_count >= DETECT_CONFIRM)
-                next_state = ROBOT_STOP;
-        } else {
-            detect_count = 0;
-        }
-
-        if (last_state == ROBOT_RUN && next_state == ROBOT_STOP)
+        // hanya kirim event, state diubah robot_state_task
+        if (detect_update(d) && robot_state_get() == ROBOT_RUN)
         {
-            espnow_msg_t msg = {
-                .cmd = CMD_TAKE_PICTURE,
-                .pot = pot_counter
-            };
-
-            esp_now_send(CAM_MAC, (uint8_t *)&msg, sizeof(msg));
+            robot_event_post(EV_OBSTACLE, pot_counter);
 
             ESP_LOGI(TAG, "STOP → pot %d → TAKE_PICTURE", pot_counter);
 
-            xSemaphoreTake(done_sem, portMAX_DELAY);
-
-            pot_counter++;
-            detect_count = 0;
-
-            robot_state = ROBOT_RUN;
-            last_state  = ROBOT_RUN;
+            // beri tahu backend dulu: upload kamera dicatat ke pot ini
+            wifi_http_post_pot(pot_counter);
+
+            if (espnow_link_capture(pot_counter))
+            {
+                pot_counter++;
+                filter_reset();
+                armed = false;
+
+                robot_event_post(EV_CAPTURE_DONE, pot_counter - 1);
+            }
+            else
+            {
+                ESP_LOGE(TAG, "Capture pot %d gagal → ROBOT_ERROR", pot_counter);
+                filter_reset();
+                robot_event_post(EV_CAPTURE_FAILED, pot_counter);
+            }
             continue;
         }
 
-        robot_state = next_state;
-        last_state  = next_state;
-
-        vTaskDelay(pdMS_TO_TICKS(200));
+        // lebih rapat saat bergerak
+        vTaskDelay(pdMS_TO_TICKS(robot_state_get() == ROBOT_RUN ? SAMPLE_MS_MOVING
+                                                                 : SAMPLE_MS_IDLE));
     }
 }
@@ -5,12 +5,16 @@
 
 /* ===== CONFIG ===== */
 #define HCSR_TEST_LOG   1   // 1 = print log, 0 = silent
+#define HCSR_STOP_CM    5   // jarak berhenti di depan pot
 
 /* ===== API ===== */
 void hcsr_init(void);
 int  hcsr_read_cm(void);
 void hcsr_task(void *pv);
 
+/* Jarak terfilter (median) ke pot berikutnya, -1 = tidak ada / belum armed */
+int  hcsr_get_distance_cm(void);
+
 /* Mutex log global (di-define di main.c) */
 extern SemaphoreHandle_t log_mutex;
 
@@ -0,0 +1,164 @@
+#include "http_pool.h"
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_system.h"
+
+#define TAG "HTTP_POOL"
+
+#define POOL_MAX_HOSTS    2
+#define POOL_HOST_LEN     64
+#define POOL_TIMEOUT_MS   5000
+#define POOL_RX_BUF       512
+#define POOL_TX_BUF       512
+#define STATS_LOG_EVERY   20
+
+typedef struct {
+    char                     host[POOL_HOST_LEN];   // "http://host:port"
+    esp_http_client_handle_t client;
+} pool_slot_t;
+
+static pool_slot_t       slots[POOL_MAX_HOSTS];
+static http_pool_stats_t stats;
+static uint64_t          total_ms;
+
+/* ================= HOST DARI URL ================= */
+static int host_len(const char *url)
+{
+    const char *p = strstr(url, "://");
+    p = p ? p + 3 : url;
+
+    const char *slash = strchr(p, '/');
+    return slash ? (int)(slash - url) : (int)strlen(url);
+}
+
+static pool_slot_t *slot_for(const char *url)
+{
+    int len = host_len(url);
+    pool_slot_t *free_slot = NULL;
+
+    if (len >= POOL_HOST_LEN)
+        return NULL;
+
+    for (int i = 0; i < POOL_MAX_HOSTS; i++)
+    {
+        if (slots[i].host[0] == 0)
+        {
+            if (!free_slot) free_slot = &slots[i];
+            continue;
+        }
+        if (strncmp(slots[i].host, url, len) == 0 && slots[i].host[len] == 0)
+            return &slots[i];
+    }
+
+    // slot penuh: pakai ulang slot pertama
+    if (!free_slot)
+    {
+        free_slot = &slots[0];
+        if (free_slot->client)
+        {
+            esp_http_client_cleanup(free_slot->client);
+            free_slot->client = NULL;
+        }
+    }
+
+    memcpy(free_slot->host, url, len);
+    free_slot->host[len] = 0;
+    return free_slot;
+}
+
+static esp_http_client_handle_t slot_client(pool_slot_t *s, const char *url)
+{
+    if (s->client)
+        return s->client;
+
+    esp_http_client_config_t cfg = {
+        .url               = url,
+        .timeout_ms        = POOL_TIMEOUT_MS,
+        .keep_alive_enable = true,
+        .buffer_size       = POOL_RX_BUF,
+        .buffer_size_tx    = POOL_TX_BUF,
+    };
+
+    s->client = esp_http_client_init(&cfg);
+    stats.connects++;
+    return s->client;
+}
+
+static void slot_drop(pool_slot_t *s)
+{
+    if (s->client)
+    {
+        esp_http_client_cleanup(s->client);
+        s->client = NULL;
+    }
+}
+
+/* ================= REQUEST ================= */
+int http_pool_request(esp_http_client_method_t method, const char *url,
+                      const char *content_type,
+                      const char *body, int body_len)
+{
+    pool_slot_t *s = slot_for(url);
+    if (!s)
+        return -1;
+
+    uint32_t heap0 = esp_get_free_heap_size();
+    int64_t  t0    = esp_timer_get_time();
+    int      status = -1;
+
+    // percobaan kedua = reconnect (server menutup koneksi keep-alive)
+    for (int attempt = 0; attempt < 2; attempt++)
+    {
+        esp_http_client_handle_t c = slot_client(s, url);
+        if (!c)
+            break;
+
+        esp_http_client_set_url(c, url);
+        esp_http_client_set_method(c, method);
+
+        if (body)
+        {
+            esp_http_client_set_header(c, "Content-Type", content_type);
+            esp_http_client_set_post_field(c, body, body_len);
+        }
+        else
+        {
+            esp_http_client_set_post_field(c, NULL, 0);
+        }
+
+        if (esp_http_client_perform(c) == ESP_OK)
+        {
+            status = esp_http_client_get_status_code(c);
+            break;
+        }
+
+        slot_drop(s);
+    }
+
+    uint32_t ms = (uint32_t)((esp_timer_get_time() - t0) / 1000);
+
+    stats.requests++;
+    if (status < 0)
+        stats.errors++;
+    stats.last_ms = ms;
+    if (ms > stats.max_ms)
+        stats.max_ms = ms;
+    total_ms += ms;
+    stats.avg_ms = total_ms / stats.requests;
+    stats.heap_delta += (int32_t)esp_get_free_heap_size() - (int32_t)heap0;
+
+    if (stats.requests % STATS_LOG_EVERY == 0)
+        ESP_LOGI(TAG, "req=%lu err=%lu conn=%lu ms avg/max=%lu/%lu heap %+ld",
+                 (unsigned long)stats.requests, (unsigned long)stats.errors,
+                 (unsigned long)stats.connects, (unsigned long)stats.avg_ms,
+                 (unsigned long)stats.max_ms, (long)stats.heap_delta);
+
+    return status;
+}
+
+void http_pool_get_stats(http_pool_stats_t *out)
+{
+    *out = stats;
+}
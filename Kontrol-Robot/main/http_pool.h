@@ -0,0 +1,29 @@
+#ifndef HTTP_POOL_H
+#define HTTP_POOL_H
+
+#include <stdint.h>
+#include "esp_http_client.h"
+
+/* =========================================================
+ *  HTTP keep-alive: 1 koneksi per host backend, dipakai ulang.
+ *  Hanya untuk satu task (wifi_http_task), tidak thread-safe.
+ * ========================================================= */
+
+typedef struct {
+    uint32_t requests;
+    uint32_t errors;
+    uint32_t connects;      // koneksi baru (awal + reconnect)
+    uint32_t last_ms;
+    uint32_t avg_ms;
+    uint32_t max_ms;
+    int32_t  heap_delta;    // perubahan free heap kumulatif (byte)
+} http_pool_stats_t;
+
+/* return status HTTP, atau -1 jika gagal setelah reconnect */
+int  http_pool_request(esp_http_client_method_t method, const char *url,
+                       const char *content_type,
+                       const char *body, int body_len);
+
+void http_pool_get_stats(http_pool_stats_t *stats);
+
+#endif
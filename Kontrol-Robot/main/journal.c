@@ -0,0 +1,284 @@
+#include "journal.h"
+#include <stddef.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_partition.h"
+#include "esp_rom/crc.h"
+
+#define TAG "JOURNAL"
+
+#define REC_MAGIC      0x4A52       // "JR"
+#define SECTOR_SIZE    4096
+#define SENT_NONE      0xFFFFFFFF   // flash terhapus
+#define SENT_DONE      0x00000000   // cukup program 1 -> 0, tanpa erase
+
+/* 32 byte: 128 record per sektor */
+typedef struct __attribute__((packed)) {
+    uint16_t magic;
+    uint8_t  type;
+    uint8_t  rsv;
+    uint16_t boot;
+    uint16_t rsv2;
+    uint32_t seq;
+    uint32_t t_ms;
+    int32_t  v0;
+    int32_t  v1;
+    uint32_t crc;       // crc32 dari field di atas
+    uint32_t sent;
+} journal_rec_t;
+
+#define REC_SIZE         sizeof(journal_rec_t)
+#define RECS_PER_SECTOR  (SECTOR_SIZE / REC_SIZE)
+#define CRC_LEN          offsetof(journal_rec_t, crc)
+
+static const esp_partition_t *part;
+
+static uint32_t slots;          // total slot record
+static uint32_t head;           // slot tulis berikutnya
+static uint32_t tail;           // slot tertua belum terkirim
+static uint32_t pending;
+static uint32_t next_seq = 1;
+static uint16_t boot_id;
+static uint32_t dropped;        // ditimpa sebelum terkirim
+
+/* ================= RECORD ================= */
+static bool rec_read(uint32_t slot, journal_rec_t *r)
+{
+    return esp_partition_read(part, slot * REC_SIZE, r, REC_SIZE) == ESP_OK;
+}
+
+static bool rec_valid(const journal_rec_t *r)
+{
+    return r->magic == REC_MAGIC &&
+           r->crc == esp_rom_crc32_le(0, (const uint8_t *)r, CRC_LEN);
+}
+
+static bool rec_blank(const journal_rec_t *r)
+{
+    const uint8_t *p = (const uint8_t *)r;
+    for (size_t i = 0; i < REC_SIZE; i++)
+        if (p[i] != 0xFF) return false;
+    return true;
+}
+
+static bool rec_unsent(const journal_rec_t *r)
+{
+    return rec_valid(r) && r->sent == SENT_NONE;
+}
+
+static uint32_t slot_next(uint32_t s)
+{
+    return (s + 1 < slots) ? s + 1 : 0;
+}
+
+/* ================= SCAN SAAT BOOT ================= */
+static void journal_scan(void)
+{
+    journal_rec_t r;
+    uint32_t max_seq = 0;
+    uint16_t max_boot = 0;
+    bool any = false;
+
+    head = 0;
+
+    for (uint32_t s = 0; s < slots; s++)
+    {
+        if (!rec_read(s, &r) || !rec_valid(&r))
+            continue;
+
+        if (!any || r.seq > max_seq)
+        {
+            max_seq = r.seq;
+            head = slot_next(s);
+        }
+        if (r.boot > max_boot)
+            max_boot = r.boot;
+        any = true;
+    }
+
+    next_seq = max_seq + 1;
+    boot_id  = max_boot + 1;
+
+    // dari head memutar = urutan tertua -> terbaru
+    tail = head;
+    pending = 0;
+
+    bool found = false;
+    uint32_t s = head;
+    for (uint32_t i = 0; i < slots; i++, s = slot_next(s))
+    {
+        if (!rec_read(s, &r) || !rec_unsent(&r))
+            continue;
+
+        if (!found)
+        {
+            tail = s;
+            found = true;
+        }
+        pending++;
+    }
+}
+
+/* ================= INIT ================= */
+esp_err_t journal_init(void)
+{
+    part = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                    ESP_PARTITION_SUBTYPE_ANY,
+                                    JOURNAL_PARTITION);
+    if (!part)
+    {
+        ESP_LOGW(TAG, "Partition '%s' not found, journal off", JOURNAL_PARTITION);
+        return ESP_ERR_NOT_FOUND;
+    }
+
+    slots = (part->size / SECTOR_SIZE) * RECS_PER_SECTOR;
+    if (slots < 2 * RECS_PER_SECTOR)
+    {
+        part = NULL;
+        return ESP_ERR_INVALID_SIZE;
+    }
+
+    journal_scan();
+
+    ESP_LOGI(TAG, "boot=%u slots=%lu head=%lu pending=%lu",
+             boot_id, (unsigned long)slots,
+             (unsigned long)head, (unsigned long)pending);
+    return ESP_OK;
+}
+
+bool journal_ready(void)
+{
+    return part != NULL;
+}
+
+uint32_t journal_pending(void)
+{
+    return pending;
+}
+
+uint16_t journal_boot(void)
+{
+    return boot_id;
+}
+
+/* ================= APPEND ================= */
+// masuk sektor baru: erase dulu, record belum terkirim di sana hilang
+static esp_err_t sector_open(uint32_t first_slot)
+{
+    journal_rec_t r;
+    uint32_t lost = 0;
+
+    for (uint32_t s = first_slot; s < first_slot + RECS_PER_SECTOR; s++)
+        if (rec_read(s, &r) && rec_unsent(&r))
+            lost++;
+
+    esp_err_t err = esp_partition_erase_range(part, first_slot * REC_SIZE, SECTOR_SIZE);
+    if (err != ESP_OK)
+        return err;
+
+    if (lost)
+    {
+        pending -= lost;
+        dropped += lost;
+        ESP_LOGW(TAG, "Journal full, dropped %lu (total %lu)",
+                 (unsigned long)lost, (unsigned long)dropped);
+    }
+
+    // tail ada di sektor yang dihapus: geser ke sektor berikutnya
+    if (tail >= first_slot && tail < first_slot + RECS_PER_SECTOR)
+        tail = pending ? (first_slot + RECS_PER_SECTOR) % slots : first_slot;
+
+    return ESP_OK;
+}
+
+esp_err_t journal_append(journal_type_t type, int32_t v0, int32_t v1)
+{
+    if (!part)
+        return ESP_ERR_INVALID_STATE;
+
+    journal_rec_t r;
+
+    // lewati slot rusak (tulis terpotong saat reset)
+    for (uint32_t tries = 0; tries < RECS_PER_SECTOR; tries++)
+    {
+        if (head % RECS_PER_SECTOR == 0)
+        {
+            esp_err_t err = sector_open(head);
+            if (err != ESP_OK)
+                return err;
+            break;
+        }
+        if (rec_read(head, &r) && rec_blank(&r))
+            break;
+        head = slot_next(head);
+    }
+
+    memset(&r, 0xFF, sizeof(r));
+    r.magic = REC_MAGIC;
+    r.type  = type;
+    r.boot  = boot_id;
+    r.seq   = next_seq;
+    r.t_ms  = (uint32_t)(esp_timer_get_time() / 1000);
+    r.v0    = v0;
+    r.v1    = v1;
+    r.crc   = esp_rom_crc32_le(0, (const uint8_t *)&r, CRC_LEN);
+
+    esp_err_t err = esp_partition_write(part, head * REC_SIZE, &r, REC_SIZE);
+    if (err != ESP_OK)
+        return err;
+
+    if (pending == 0)
+        tail = head;
+
+    next_seq++;
+    pending++;
+    head = slot_next(head);
+    return ESP_OK;
+}
+
+/* ================= REPLAY ================= */
+int journal_peek(journal_entry_t *out, int max)
+{
+    journal_rec_t r;
+    int n = 0;
+    uint32_t s = tail;
+
+    for (uint32_t i = 0; part && i < slots && n < max && s != head; i++, s = slot_next(s))
+    {
+        if (!rec_read(s, &r) || !rec_unsent(&r))
+            continue;
+
+        out[n].type = r.type;
+        out[n].boot = r.boot;
+        out[n].seq  = r.seq;
+        out[n].t_ms = r.t_ms;
+        out[n].v0   = r.v0;
+        out[n].v1   = r.v1;
+        n++;
+    }
+
+    return n;
+}
+
+void journal_consume(int n)
+{
+    journal_rec_t r;
+    const uint32_t done = SENT_DONE;
+
+    while (part && n > 0 && pending > 0)
+    {
+        if (rec_read(tail, &r) && rec_unsent(&r))
+        {
+            esp_partition_write(part, tail * REC_SIZE + offsetof(journal_rec_t, sent),
+                                &done, sizeof(done));
+            pending--;
+            n--;
+        }
+        tail = slot_next(tail);
+    }
+
+    if (pending == 0)
+        tail = head;
+}
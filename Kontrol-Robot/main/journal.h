@@ -0,0 +1,45 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/* =========================================================
+ *  JOURNAL: ring append-only di partisi flash "journal".
+ *  Menyimpan sampel DHT dan pot selama link putus, diputar ulang
+ *  berurutan saat online. Hanya dipakai wifi_http_task.
+ *  Pot diputar ulang ke /pot/history (riwayat saja), bukan /pot:
+ *  pot basi tidak boleh menimpa pot aktif di backend.
+ * ========================================================= */
+
+#define JOURNAL_PARTITION   "journal"
+
+typedef enum {
+    JOURNAL_DHT = 1,     // v0 = suhu x100, v1 = humidity x100
+    JOURNAL_POT = 2      // v0 = nomor pot
+} journal_type_t;
+
+typedef struct {
+    uint8_t  type;
+    uint16_t boot;       // nomor boot saat dicatat
+    uint32_t seq;
+    uint32_t t_ms;       // uptime saat dicatat
+    int32_t  v0;
+    int32_t  v1;
+} journal_entry_t;
+
+esp_err_t journal_init(void);
+bool      journal_ready(void);
+uint32_t  journal_pending(void);
+uint16_t  journal_boot(void);
+
+esp_err_t journal_append(journal_type_t type, int32_t v0, int32_t v1);
+
+/* entri belum terkirim, tertua dulu; tidak menghapus */
+int       journal_peek(journal_entry_t *out, int max);
+
+/* tandai n entri tertua sebagai terkirim */
+void      journal_consume(int n);
+
+#endif
@@ -2,18 +2,92 @@
 #include "motor.h"
 #include "robot_state.h"
 #include "qtr.h"
+#include "pid.h"
+#include "odom.h"
+#include "hcsr.h"
+#include "telemetry.h"
 
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 
-#define KP 0.018f
-#define KD 0.0001f
+#include "esp_log.h"
+#include "esp_timer.h"
 
-#define BASE_SPEED 3500
-#define MAX_SPEED  6000
-#define CENTER     3500
+/* ===== PID ===== */
+#define PID_D_TAU       0.02f   // s, LPF derivative
+#define PID_I_LIMIT     3080    // perintah, clamp integral (offset tetap di tikungan)
 
-static int last_error = 0;
+/* ===== LOOP RATE ===== */
+#define LF_RATE_HZ      200     // maks 1000
+#define LF_PERIOD_US    (1000000 / LF_RATE_HZ)
+#define TELEM_DECIM     8       // 1 sampel telemetry per 8 tick (25 Hz)
+
+/*
+ * Kecepatan roda = perintah motor_set(): linear di atas deadband,
+ * 1 = duty deadband (4200), 8191 = PWM_MAX. duty ~ 4200 + cmd * 0.49
+ */
+#define BASE_SPEED 3490      // duty ~5900, ~380 mm/s
+#define MAX_SPEED  8191      // PWM_MAX: roda luar masih bisa dipercepat
+#define MIN_SPEED  (-1000)   // negatif = roda dalam boleh mundur pelan (pivot)
+#define CENTER     QTR_CENTER
+
+#define BRAKE_TIME_MS   80   // short-brake saat masuk ROBOT_STOP
+
+/* ===== APPROACH POT (HC-SR04) ===== */
+#define APPROACH_CM         40     // mulai melambat
+#define APPROACH_MIN_SPEED  300    // kecepatan saat di HCSR_STOP_CM, duty ~4350
+
+/* ===== RECOVERY GARIS HILANG ===== */
+#define RECOVER_SPEED    800    // maju pelan sambil mencari, duty ~4590
+#define RECOVER_TURN     1900   // selisih roda ke arah error terakhir
+#define LOST_TIMEOUT_MS  800    // lalu ROBOT_ERROR
+#define LOST_DIST_MM     250    // atau jarak tempuh (jika encoder ada)
+
+/* ===== SPEED LOOP (encoder) ===== */
+#ifndef SPEED_LOOP
+#define SPEED_LOOP      0       // 1 = perintah roda = kecepatan terukur (setelah odom_active), 0 = PWM open-loop
+#endif
+#define CMD_FULL        8191    // perintah penuh = ODOM_MAX_SPEED_MM_S
+#define WHEEL_I_LIMIT   1500    // perintah
+
+/* ===== KALIBRASI QTR ===== */
+#define CAL_FORCE       0       // 1 = selalu kalibrasi ulang saat boot
+#define CAL_TIME_MS     5000    // durasi sapuan manual di atas garis
+
+static const char *TAG = "LINE";
+
+/*
+ * Gain dijadwal menurut |error| (0 – 3500), unit perintah per unit posisi
+ * (1 perintah ~ 0.49 duty). Dituning di host/lf_sim (oval R 300 & R 200,
+ * dengan/tanpa encoder): rms ~3.5 mm, tanpa garis hilang. Cek ulang di lantai.
+ */
+static const pid_sched_t line_sched[] = {
+    {  800, { .kp = 0.82f, .ki = 2.05f, .kd = 0.16f } },
+    { 2000, { .kp = 1.23f, .ki = 2.05f, .kd = 0.16f } },
+    { 3500, { .kp = 1.64f, .ki = 0.0f,  .kd = 0.21f } },
+};
+
+static pid_ctrl_t line_pid;
+
+/* PI per roda: error mm/s -> koreksi PWM di atas feedforward */
+static const pid_gains_t wheel_gains = { .kp = 2.0f, .ki = 10.0f, .kd = 0.0f };
+static pid_ctrl_t wheel_pid[2];
+
+static int speed_limit = BASE_SPEED;
+
+/* state recovery */
+static int     last_error_sign = 0;   // +1 garis di kiri, -1 di kanan
+static bool    line_lost       = false;
+static float   lost_time_s     = 0.0f;
+static int32_t lost_start_mm   = 0;
+
+static TaskHandle_t       lf_task_handle;
+static esp_timer_handle_t lf_timer;
+
+/* ===== STATISTIK ===== */
+static portMUX_TYPE stats_lock = portMUX_INITIALIZER_UNLOCKED;
+static linefollow_stats_t stats;
+static uint64_t period_sum_us;
 
 static int clamp(int val, int min, int max)
 {
@@ -22,50 +96,330 @@ static int clamp(int val, int min, int max)
     return val;
 }
 
+static void linefollow_calibrate(void)
+{
+    if (!CAL_FORCE && qtr_calibration_load())
+        return;
+
+    ESP_LOGW(TAG, "Kalibrasi QTR: sapukan robot di atas garis (%d ms)",
+             CAL_TIME_MS);
+
+    qtr_calibrate_reset();
+
+    int64_t t_end = esp_timer_get_time() + (int64_t)CAL_TIME_MS * 1000;
+    while (esp_timer_get_time() < t_end)
+    {
+        qtr_calibrate();
+        vTaskDelay(pdMS_TO_TICKS(10));
+    }
+
+    if (!qtr_calibration_save())
+        ESP_LOGW(TAG, "Kalibrasi gagal, pakai nilai raw");
+}
+
+/* =========================================================
+ *  HUKUM KONTROL (tanpa I/O)
+ * ========================================================= */
+void linefollow_control_init(void)
+{
+    pid_init(&line_pid, line_sched[0].gains, -MAX_SPEED, MAX_SPEED);
+    pid_set_schedule(&line_pid, line_sched,
+                     sizeof(line_sched) / sizeof(line_sched[0]));
+    line_pid.d_tau   = PID_D_TAU;
+    line_pid.i_limit = PID_I_LIMIT;
+
+    for (int i = 0; i < 2; i++)
+    {
+        pid_init(&wheel_pid[i], wheel_gains, -CMD_FULL, CMD_FULL);
+        wheel_pid[i].i_limit = WHEEL_I_LIMIT;
+    }
+}
+
+void linefollow_control_reset(void)
+{
+    line_lost   = false;
+    lost_time_s = 0.0f;
+
+    pid_reset(&line_pid);
+    pid_reset(&wheel_pid[MOTOR_LEFT]);
+    pid_reset(&wheel_pid[MOTOR_RIGHT]);
+}
+
+/* Perintah roda (skala motor_set) -> kecepatan target, koreksi dari encoder */
+static int wheel_speed_ctl(motor_wheel_t w, int cmd, float dt)
+{
+    // tanpa count encoder, PI hanya melihat 0 mm/s dan memacu roda
+    if (!SPEED_LOOP || !odom_active())
+        return cmd;
+
+    if (cmd == 0)
+    {
+        pid_reset(&wheel_pid[w]);
+        return 0;
+    }
+
+    float target = (float)cmd * ODOM_MAX_SPEED_MM_S / CMD_FULL;
+    float corr   = pid_update(&wheel_pid[w], target - odom_speed_mm_s(w), dt);
+
+    return clamp(cmd + (int)corr, -CMD_FULL, CMD_FULL);
+}
+
+/*
+ * Batas kecepatan dari jarak pot: linear dari BASE_SPEED
+ * di APPROACH_CM turun ke APPROACH_MIN_SPEED di HCSR_STOP_CM.
+ */
+int linefollow_approach_limit(int dist_cm)
+{
+    if (dist_cm < 0 || dist_cm >= APPROACH_CM)
+        return BASE_SPEED;
+    if (dist_cm <= HCSR_STOP_CM)
+        return APPROACH_MIN_SPEED;
+
+    return APPROACH_MIN_SPEED +
+           (BASE_SPEED - APPROACH_MIN_SPEED) * (dist_cm - HCSR_STOP_CM) /
+           (APPROACH_CM - HCSR_STOP_CM);
+}
+
+void linefollow_set_speed_limit(int limit)
+{
+    speed_limit = limit;
+}
+
+/*
+ * Garis hilang: belok pelan ke sisi error terakhir, atau lurus jika
+ * belum pernah ada error (mis. frame pertama setelah start/resume).
+ * Menyerah setelah LOST_TIMEOUT_MS atau LOST_DIST_MM.
+ */
+static lf_result_t linefollow_recover(float dt, int *left, int *right)
+{
+    if (!line_lost)
+    {
+        line_lost     = true;
+        lost_time_s   = 0.0f;
+        lost_start_mm = odom_distance_mm();
+        pid_reset(&line_pid);
+    }
+
+    lost_time_s += dt;
+
+    int32_t lost_mm = odom_distance_mm() - lost_start_mm;
+    if (lost_mm < 0)
+        lost_mm = -lost_mm;
+
+    if (lost_time_s * 1000.0f >= LOST_TIMEOUT_MS ||
+        (odom_active() && lost_mm >= LOST_DIST_MM))
+    {
+        *left  = 0;
+        *right = 0;
+        return LF_LOST;
+    }
+
+    // last_error_sign 0: selisih 0, cari lurus ke depan
+    *left  = RECOVER_SPEED - last_error_sign * RECOVER_TURN;
+    *right = RECOVER_SPEED + last_error_sign * RECOVER_TURN;
+    return LF_RECOVERING;
+}
+
+lf_result_t linefollow_step(int pos, int confidence, float dt,
+                            int *left, int *right)
+{
+    if (pos < 0)
+        return linefollow_recover(dt, left, right);
+
+    line_lost = false;
+
+    int base = speed_limit < BASE_SPEED ? speed_limit : BASE_SPEED;
+
+    /*
+     * Gelap merata (persimpangan / garis melintang): posisi tidak bisa
+     * dipercaya. Lurus dulu, state PID dibiarkan (tanpa windup / D kick).
+     */
+    if (confidence < QTR_MIN_CONFIDENCE)
+    {
+        *left  = base;
+        *right = base;
+        return LF_TRACKING;
+    }
+
+    int error = pos - CENTER;
+
+    if (error != 0)
+        last_error_sign = error > 0 ? 1 : -1;
+
+    pid_schedule(&line_pid, error);
+    int corr = (int)pid_update(&line_pid, error, dt);
+
+    *left  = clamp(base - corr, MIN_SPEED, MAX_SPEED);
+    *right = clamp(base + corr, MIN_SPEED, MAX_SPEED);
+    return LF_TRACKING;
+}
+
+/* =========================================================
+ *  TASK
+ * ========================================================= */
+static void lf_tick_cb(void *arg)
+{
+    xTaskNotifyGive(lf_task_handle);
+}
+
+static void stats_reset(void)
+{
+    stats.rate_hz       = LF_RATE_HZ;
+    stats.cycles        = 0;
+    stats.period_min_us = UINT32_MAX;
+    stats.period_max_us = 0;
+    stats.period_avg_us = 0;
+    stats.jitter_us     = 0;
+    stats.overruns      = 0;
+    stats.qtr_errors    = 0;
+    period_sum_us       = 0;
+}
+
+static void stats_update(uint32_t period_us, uint32_t missed)
+{
+    uint32_t dev = period_us > LF_PERIOD_US ? period_us - LF_PERIOD_US
+                                            : LF_PERIOD_US - period_us;
+
+    portENTER_CRITICAL(&stats_lock);
+
+    stats.cycles++;
+    period_sum_us += period_us;
+
+    if (period_us < stats.period_min_us) stats.period_min_us = period_us;
+    if (period_us > stats.period_max_us) stats.period_max_us = period_us;
+    if (dev > stats.jitter_us)           stats.jitter_us     = dev;
+
+    stats.overruns     += missed;
+    stats.period_avg_us = period_sum_us / stats.cycles;
+
+    portEXIT_CRITICAL(&stats_lock);
+}
+
+void linefollow_get_stats(linefollow_stats_t *out, bool reset)
+{
+    portENTER_CRITICAL(&stats_lock);
+
+    *out = stats;
+    if (out->cycles == 0)
+        out->period_min_us = 0;
+
+    if (reset)
+        stats_reset();
+
+    portEXIT_CRITICAL(&stats_lock);
+}
+
 void linefollow_task(void *pv)
 {
     qtr_init();   // PENTING
+    linefollow_calibrate();
+
+    lf_task_handle = xTaskGetCurrentTaskHandle();
+    stats_reset();
+
+    linefollow_control_init();
+
+    esp_timer_create_args_t targs = {
+        .callback = lf_tick_cb,
+        .name     = "lf_tick",
+    };
+    esp_timer_create(&targs, &lf_timer);
+    esp_timer_start_periodic(lf_timer, LF_PERIOD_US);
+
+    int64_t last_tick = esp_timer_get_time();
+    int64_t brake_until = 0;
+    robot_state_t prev_state = ROBOT_RUN;
+    int telem_div = 0;
 
     while (1)
     {
-        switch (robot_state)
+        // tunggu tick periodik (bukan vTaskDelay setelah kerja)
+        uint32_t ticks = ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+        int64_t now = esp_timer_get_time();
+        uint32_t period_us = (uint32_t)(now - last_tick);
+        last_tick = now;
+
+        stats_update(period_us, ticks > 1 ? ticks - 1 : 0);
+
+        float dt = (period_us ? period_us : LF_PERIOD_US) * 1e-6f;
+
+        odom_update(dt);
+
+        robot_state_t state = robot_state_get();
+        telemetry_sample_t ts = {
+            .t_ms    = (uint32_t)(now / 1000),
+            .pos     = -1,
+            .dist_cm = -1,
+            .state   = state,
+        };
+
+        switch (state)
         {
             case ROBOT_RUN:
             {
-                int pos = qtr_read_position();
+                int left, right;
+                qtr_line_t line;
+                int dist = hcsr_get_distance_cm();
 
-                // ===== garis hilang =====
-                if (pos < 0)
+                // frame gagal: tahan perintah terakhir, jangan anggap gelap semua
+                if (!qtr_read_line(&line))
                 {
-                    motor_stop();
+                    portENTER_CRITICAL(&stats_lock);
+                    stats.qtr_errors++;
+                    portEXIT_CRITICAL(&stats_lock);
                     break;
                 }
 
-                int error = pos - CENTER;
-                int corr  = (int)(KP * error + KD * (error - last_error));
-                last_error = error;
+                ts.pos     = line.position;
+                ts.dist_cm = dist;
 
-                int left  = BASE_SPEED - corr;
-                int right = BASE_SPEED + corr;
+                linefollow_set_speed_limit(linefollow_approach_limit(dist));
 
-                left  = clamp(left,  0, MAX_SPEED);
-                right = clamp(right, 0, MAX_SPEED);
+                // ===== garis hilang terlalu lama =====
+                if (linefollow_step(line.position, line.confidence, dt,
+                                    &left, &right) == LF_LOST)
+                {
+                    ESP_LOGW(TAG, "Garis hilang, ROBOT_ERROR");
+                    linefollow_control_reset();
+                    motor_stop();
+                    robot_event_post(EV_LINE_LOST, line.position);
+                    break;
+                }
 
-                motor_set(left, right);
+                ts.left  = wheel_speed_ctl(MOTOR_LEFT,  left,  dt);
+                ts.right = wheel_speed_ctl(MOTOR_RIGHT, right, dt);
+                motor_set(ts.left, ts.right);
                 break;
             }
 
             case ROBOT_STOP:
-                motor_stop();
+                linefollow_control_reset();
+
+                // rem keras sebentar saat baru berhenti, lalu lepas
+                if (prev_state != ROBOT_STOP)
+                    brake_until = now + BRAKE_TIME_MS * 1000;
+
+                if (now < brake_until)
+                    motor_brake();
+                else
+                    motor_stop();
                 break;
 
             case ROBOT_ERROR:
             default:
+                linefollow_control_reset();
                 motor_stop();
                 break;
         }
 
-        vTaskDelay(pdMS_TO_TICKS(10));
+        if (++telem_div >= TELEM_DECIM)
+        {
+            telem_div = 0;
+            telemetry_record(&ts);
+        }
+
+        prev_state = state;
     }
 }
 
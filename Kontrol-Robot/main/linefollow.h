@@ -1,7 +1,41 @@
 #ifndef LINEFOLLOW_H
 #define LINEFOLLOW_H
 
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ===== STATISTIK LOOP KONTROL ===== */
+typedef struct {
+    uint32_t rate_hz;         // laju nominal
+    uint32_t cycles;          // jumlah periode dalam window
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint32_t period_avg_us;
+    uint32_t jitter_us;       // deviasi maksimum dari periode nominal
+    uint32_t overruns;        // tick yang terlewat
+    uint32_t qtr_errors;      // frame QTR gagal (perintah motor ditahan)
+} linefollow_stats_t;
+
 void linefollow_task(void *pv);
+void linefollow_get_stats(linefollow_stats_t *stats, bool reset);
 
-#endif
+typedef enum {
+    LF_TRACKING = 0,   // mengikuti garis
+    LF_RECOVERING,     // garis hilang, mencari ke arah error terakhir
+    LF_LOST            // menyerah (timeout / jarak)
+} lf_result_t;
 
+/*
+ * Hukum kontrol tanpa akses hardware/RTOS:
+ * posisi + confidence QTR (qtr_line_t) + dt -> perintah PWM roda.
+ */
+void        linefollow_control_init(void);
+void        linefollow_control_reset(void);
+lf_result_t linefollow_step(int pos, int confidence, float dt,
+                            int *left, int *right);
+
+/* Batas base speed (mis. dari jarak pot), berlaku di step berikutnya */
+void        linefollow_set_speed_limit(int limit);
+int         linefollow_approach_limit(int dist_cm);
+
+#endif
@@ -4,7 +4,6 @@
 /* FreeRTOS */
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
-#include "freertos/queue.h"
 #include "freertos/semphr.h"
 
 /* ESP-IDF */
@@ -13,14 +12,15 @@
 
 /* Project headers */
 #include "motor.h"
+#include "odom.h"
 #include "linefollow.h"
 #include "hcsr.h"
 #include "dht_task.h"
 #include "wifi_http.h"
 #include "robot_state.h"
+#include "conn.h"
 
 /* ===== GLOBAL ===== */
-QueueHandle_t dht_queue;
 SemaphoreHandle_t log_mutex;
 
 /* =========================================================
@@ -29,11 +29,26 @@ SemaphoreHandle_t log_mutex;
 static void monitor_task(void *pv)
 {
     char stats[512];
+    linefollow_stats_t lf;
 
     while (1)
     {
         vTaskGetRunTimeStats(stats);
         ESP_LOGI("RTOS_STATS", "\nTask Runtime Stats:\n%s", stats);
+
+        linefollow_get_stats(&lf, true);
+        ESP_LOGI("LINE_STATS",
+                 "rate=%luHz n=%lu period min/avg/max=%lu/%lu/%lu us jitter=%lu us overrun=%lu qtr_err=%lu",
+                 (unsigned long)lf.rate_hz, (unsigned long)lf.cycles,
+                 (unsigned long)lf.period_min_us, (unsigned long)lf.period_avg_us,
+                 (unsigned long)lf.period_max_us, (unsigned long)lf.jitter_us,
+                 (unsigned long)lf.overruns, (unsigned long)lf.qtr_errors);
+
+        if (odom_ok())
+            ESP_LOGI("ODOM", "dist=%ld mm  L=%.0f R=%.0f mm/s",
+                     (long)odom_distance_mm(),
+                     odom_speed_mm_s(MOTOR_LEFT), odom_speed_mm_s(MOTOR_RIGHT));
+
         vTaskDelay(pdMS_TO_TICKS(5000));
     }
 }
@@ -45,23 +60,28 @@ void app_main(void)
 {
     ESP_ERROR_CHECK(nvs_flash_init());
 
-    robot_state = ROBOT_RUN;
+    robot_state_init(ROBOT_RUN);
 
     /* ===== Mutex log ===== */
     log_mutex = xSemaphoreCreateMutex();
 
+    /* ===== WiFi + ESP-NOW (sekali, sebelum task) ===== */
+    conn_init();
+
     /* ===== Init hardware ===== */
     motor_init();
+    odom_init();
 
-    /* ===== Queue DHT ===== */
-    dht_queue = xQueueCreate(4, sizeof(dht_data_t));
-    if (!dht_queue)
+    /* ===== Antrian jaringan (pot, DHT, conn, hasil WS) ===== */
+    if (wifi_http_init() != ESP_OK)
     {
-        ESP_LOGE("MAIN", "Failed to create DHT queue");
+        ESP_LOGE("MAIN", "Failed to init HTTP queues");
         return;
     }
 
     /* ===== TASKS ===== */
+    // pemilik state di atas linefollow pada core yang sama: event langsung diterapkan
+    xTaskCreatePinnedToCore(robot_state_task, "state", 3072, NULL, 7, NULL, 1);
     xTaskCreatePinnedToCore(linefollow_task, "line", 4096, NULL, 6, NULL, 1);
     xTaskCreatePinnedToCore(hcsr_task,       "hcsr", 4096, NULL, 5, NULL, 1);
     xTaskCreatePinnedToCore(wifi_http_task,  "wifi", 6144, NULL, 4, NULL, 0);
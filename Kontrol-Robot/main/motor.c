@@ -1,11 +1,9 @@
 #include "motor.h"
 #include <stdbool.h>
 
-#include "freertos/FreeRTOS.h"
-#include "freertos/task.h"
-
 #include "driver/gpio.h"
 #include "driver/ledc.h"
+#include "esp_timer.h"
 
 /* ===== PIN ===== */
 #define IN1 15
@@ -20,8 +18,47 @@
 #define PWM_START_MIN  4200
 #define PWM_KICK       6500
 #define KICK_TIME_MS   60
+#define ZERO_HYST      400     // perintah, pita balik arah (tanpa kick berulang)
+
+/* ===== SLEW ===== */
+#define ACCEL_PWM_PER_S  60000   // perubahan perintah maks per detik (0 = tanpa batas)
+
+/*
+ * Kick-start per roda, non-blocking:
+ * roda yang mulai dari diam dapat PWM_KICK selama KICK_TIME_MS,
+ * diakhiri oleh panggilan motor_set() berikutnya (tick kontrol).
+ */
+typedef struct {
+    int            in_a;         // HIGH = maju
+    int            in_b;         // HIGH = mundur
+    ledc_channel_t channel;
+
+    /* kalibrasi: duty = deadband + |cmd| * (PWM_MAX - deadband) / PWM_MAX * gain */
+    int            deadband;
+    float          gain;
+
+    int            dir;          // +1 maju, -1 mundur, 0 diam
+    int64_t        kick_until;   // us, 0 = tidak kick
+
+    float          cmd;          // perintah setelah slew
+    int64_t        last_us;
+
+    /* output terakhir, tulis ulang hanya jika berubah */
+    int            out_a, out_b, out_duty;
+} wheel_t;
+
+static wheel_t wheel_left  = {
+    .in_a = IN1, .in_b = IN2, .channel = LEDC_CHANNEL_0,
+    .deadband = PWM_START_MIN, .gain = 1.0f,
+    .out_a = -1, .out_b = -1, .out_duty = -1,
+};
+static wheel_t wheel_right = {
+    .in_a = IN3, .in_b = IN4, .channel = LEDC_CHANNEL_1,
+    .deadband = PWM_START_MIN, .gain = 1.0f,
+    .out_a = -1, .out_b = -1, .out_duty = -1,
+};
 
-static bool motor_started = false;
+static int accel_pwm_per_s = ACCEL_PWM_PER_S;
 
 /* ===================================================== */
 void motor_init(void)
@@ -68,51 +105,157 @@ void motor_init(void)
 }
 
 /* ===================================================== */
+static void wheel_output(wheel_t *w, int in_a, int in_b, int duty)
+{
+    if (in_a != w->out_a || in_b != w->out_b)
+    {
+        gpio_set_level(w->in_a, in_a);
+        gpio_set_level(w->in_b, in_b);
+        w->out_a = in_a;
+        w->out_b = in_b;
+    }
+
+    if (duty != w->out_duty)
+    {
+        ledc_set_duty(LEDC_LOW_SPEED_MODE, w->channel, duty);
+        ledc_update_duty(LEDC_LOW_SPEED_MODE, w->channel);
+        w->out_duty = duty;
+    }
+}
+
+static void wheel_halt(wheel_t *w)
+{
+    w->dir        = 0;
+    w->kick_until = 0;
+    w->cmd        = 0.0f;
+    w->last_us    = 0;     // start berikutnya naik dari 0
+}
+
+/* ===================================================== */
+/* COAST: driver lepas, motor berhenti sendiri */
 void motor_stop(void)
 {
-    motor_started = false;
+    wheel_halt(&wheel_left);
+    wheel_halt(&wheel_right);
 
-    gpio_set_level(IN1, 0);
-    gpio_set_level(IN2, 0);
-    gpio_set_level(IN3, 0);
-    gpio_set_level(IN4, 0);
+    wheel_output(&wheel_left,  0, 0, 0);
+    wheel_output(&wheel_right, 0, 0, 0);
+}
 
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, 0);
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, 0);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1);
+void motor_coast(void)
+{
+    motor_stop();
 }
 
 /* ===================================================== */
-void motor_set(int left, int right)
+/* BRAKE: terminal motor di-short (IN_A = IN_B = 1, EN penuh) */
+void motor_brake(void)
 {
-    if (left  > 0 && left  < PWM_START_MIN) left  = PWM_START_MIN;
-    if (right > 0 && right < PWM_START_MIN) right = PWM_START_MIN;
+    wheel_halt(&wheel_left);
+    wheel_halt(&wheel_right);
 
-    if (left  > PWM_MAX) left  = PWM_MAX;
-    if (right > PWM_MAX) right = PWM_MAX;
+    wheel_output(&wheel_left,  1, 1, PWM_MAX);
+    wheel_output(&wheel_right, 1, 1, PWM_MAX);
+}
+
+/* ===================================================== */
+static void wheel_set(wheel_t *w, int speed, int64_t now)
+{
+    if (speed >  PWM_MAX) speed =  PWM_MAX;
+    if (speed < -PWM_MAX) speed = -PWM_MAX;
 
-    /* MAJU */
-    gpio_set_level(IN1, 1);
-    gpio_set_level(IN2, 0);
-    gpio_set_level(IN3, 1);
-    gpio_set_level(IN4, 0);
+    /* Slew per tick: batasi perubahan perintah sesuai dt */
+    float dt = w->last_us ? (now - w->last_us) * 1e-6f : 0.0f;
+    w->last_us = now;
 
-    /* Kick-start SEKALI */
-    if (!motor_started && (left || right))
+    if (accel_pwm_per_s > 0)
     {
-        ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, PWM_KICK);
-        ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, PWM_KICK);
-        ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
-        ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1);
+        float step = accel_pwm_per_s * dt;
+        float diff = speed - w->cmd;
 
-        vTaskDelay(pdMS_TO_TICKS(KICK_TIME_MS));
-        motor_started = true;
+        if (diff >  step) diff =  step;
+        if (diff < -step) diff = -step;
+        w->cmd += diff;
     }
+    else
+    {
+        w->cmd = speed;
+    }
+
+    int cmd  = (int)w->cmd;
+    int dir  = (cmd > 0) - (cmd < 0);
+    int duty = 0;
 
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0, left);
-    ledc_set_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1, right);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_0);
-    ledc_update_duty(LEDC_LOW_SPEED_MODE, LEDC_CHANNEL_1);
+    /*
+     * Hysteresis zero-crossing: roda yang sedang jalan baru balik arah
+     * jika perintah melewati -ZERO_HYST. Di dalam pita: coast, arah dan
+     * kick tidak berubah (roda dalam yang berayun di sekitar 0).
+     */
+    if (dir != 0 && w->dir != 0 && dir != w->dir &&
+        cmd > -ZERO_HYST && cmd < ZERO_HYST)
+    {
+        wheel_output(w, 0, 0, 0);
+        return;
+    }
+
+    /* Deadband + gain per roda (ganti snap ke PWM_START_MIN) */
+    if (dir != 0)
+    {
+        int mag = cmd < 0 ? -cmd : cmd;
+        duty = (int)((w->deadband +
+                      (float)mag * (PWM_MAX - w->deadband) / PWM_MAX) * w->gain);
+        if (duty > PWM_MAX) duty = PWM_MAX;
+    }
+
+    if (dir == 0)
+    {
+        w->dir        = 0;
+        w->kick_until = 0;
+        wheel_output(w, 0, 0, 0);
+        return;
+    }
+
+    /* Kick-start: mulai dari diam atau ganti arah */
+    if (dir != w->dir)
+    {
+        w->dir        = dir;
+        w->kick_until = now + KICK_TIME_MS * 1000;
+    }
+
+    if (w->kick_until)
+    {
+        if (now < w->kick_until)
+            duty = duty > PWM_KICK ? duty : PWM_KICK;
+        else
+            w->kick_until = 0;
+    }
+
+    wheel_output(w, dir > 0, dir < 0, duty);
 }
 
+/* ===================================================== */
+void motor_set_wheel_cal(motor_wheel_t wheel, int deadband, float gain)
+{
+    wheel_t *w = (wheel == MOTOR_LEFT) ? &wheel_left : &wheel_right;
+
+    if (deadband < 0)       deadband = 0;
+    if (deadband > PWM_MAX) deadband = PWM_MAX;
+
+    w->deadband = deadband;
+    w->gain     = gain;
+}
+
+void motor_set_accel(int pwm_per_s)
+{
+    accel_pwm_per_s = pwm_per_s;
+}
+
+/* ===================================================== */
+/* speed: -PWM_MAX .. PWM_MAX, negatif = mundur */
+void motor_set(int left, int right)
+{
+    int64_t now = esp_timer_get_time();
+
+    wheel_set(&wheel_left,  left,  now);
+    wheel_set(&wheel_right, right, now);
+}
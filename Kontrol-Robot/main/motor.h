@@ -1,9 +1,27 @@
 #ifndef MOTOR_H
 #define MOTOR_H
 
+typedef enum {
+    MOTOR_LEFT = 0,
+    MOTOR_RIGHT
+} motor_wheel_t;
+
 void motor_init(void);
 void motor_stop(void);
+void motor_coast(void);
+void motor_brake(void);
+
+/*
+ * -8191 .. 8191, negatif = mundur. Linear di atas deadband roda:
+ * 1 = duty deadband (mulai berputar), 8191 = PWM_MAX.
+ * Balik arah butuh |perintah| > pita hysteresis (tanpa kick berulang).
+ */
 void motor_set(int left_speed, int right_speed);
 
+/* deadband = duty minimal roda mulai berputar, gain = koreksi roda */
+void motor_set_wheel_cal(motor_wheel_t wheel, int deadband, float gain);
+/* 0 = tanpa slew */
+void motor_set_accel(int pwm_per_s);
+
 #endif
 
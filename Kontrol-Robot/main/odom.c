@@ -0,0 +1,154 @@
+#include "odom.h"
+#include <stdlib.h>
+
+#include "driver/pulse_cnt.h"
+#include "esp_log.h"
+
+/* ===== PIN ENCODER (quadrature A/B) ===== */
+#define ENC_L_A  7
+#define ENC_L_B  8
+#define ENC_R_A  9
+#define ENC_R_B  10
+
+/* ===== MEKANIK ===== */
+#define ENC_COUNTS_PER_REV  1320   // 11 PPR x 30:1 x4 (sesuaikan motor)
+#define WHEEL_DIAM_MM       65.0f
+#define MM_PER_COUNT        (3.14159265f * WHEEL_DIAM_MM / ENC_COUNTS_PER_REV)
+
+#define PCNT_LIMIT          30000
+#define GLITCH_NS           1000
+#define SPEED_LPF           0.3f   // 0..1, bobot sampel baru
+#define ACTIVE_COUNTS       20     // count per roda sebelum encoder dianggap hidup (~3 mm)
+
+static const char *TAG = "ODOM";
+
+typedef struct {
+    pcnt_unit_handle_t unit;
+    int                last_count;
+    float              speed;      // mm/s
+    float              dist;       // mm
+} enc_t;
+
+static enc_t enc[2];
+static bool  enc_ok     = false;   // PCNT siap (belum tentu ada encoder)
+static bool  enc_active = false;   // count sudah terlihat di kedua roda
+
+static volatile int32_t distance_mm = 0;
+static float            dist_base   = 0.0f;
+
+// ==========================================
+static esp_err_t enc_init(enc_t *e, int pin_a, int pin_b)
+{
+    pcnt_unit_config_t ucfg = {
+        .low_limit  = -PCNT_LIMIT,
+        .high_limit =  PCNT_LIMIT,
+        .flags.accum_count = 1,   // count tidak reset di limit
+    };
+    esp_err_t err = pcnt_new_unit(&ucfg, &e->unit);
+    if (err != ESP_OK)
+        return err;
+
+    pcnt_glitch_filter_config_t fcfg = { .max_glitch_ns = GLITCH_NS };
+    pcnt_unit_set_glitch_filter(e->unit, &fcfg);
+
+    pcnt_chan_config_t ca = { .edge_gpio_num = pin_a, .level_gpio_num = pin_b };
+    pcnt_chan_config_t cb = { .edge_gpio_num = pin_b, .level_gpio_num = pin_a };
+    pcnt_channel_handle_t ch_a, ch_b;
+
+    pcnt_new_channel(e->unit, &ca, &ch_a);
+    pcnt_new_channel(e->unit, &cb, &ch_b);
+
+    // decode x4
+    pcnt_channel_set_edge_action(ch_a, PCNT_CHANNEL_EDGE_ACTION_DECREASE,
+                                       PCNT_CHANNEL_EDGE_ACTION_INCREASE);
+    pcnt_channel_set_level_action(ch_a, PCNT_CHANNEL_LEVEL_ACTION_KEEP,
+                                        PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+    pcnt_channel_set_edge_action(ch_b, PCNT_CHANNEL_EDGE_ACTION_INCREASE,
+                                       PCNT_CHANNEL_EDGE_ACTION_DECREASE);
+    pcnt_channel_set_level_action(ch_b, PCNT_CHANNEL_LEVEL_ACTION_KEEP,
+                                        PCNT_CHANNEL_LEVEL_ACTION_INVERSE);
+
+    pcnt_unit_add_watch_point(e->unit,  PCNT_LIMIT);
+    pcnt_unit_add_watch_point(e->unit, -PCNT_LIMIT);
+
+    pcnt_unit_enable(e->unit);
+    pcnt_unit_clear_count(e->unit);
+    pcnt_unit_start(e->unit);
+
+    e->last_count = 0;
+    e->speed      = 0.0f;
+    e->dist       = 0.0f;
+    return ESP_OK;
+}
+
+void odom_init(void)
+{
+    if (enc_init(&enc[MOTOR_LEFT],  ENC_L_A, ENC_L_B) != ESP_OK ||
+        enc_init(&enc[MOTOR_RIGHT], ENC_R_A, ENC_R_B) != ESP_OK)
+    {
+        ESP_LOGE(TAG, "PCNT init gagal, odometri nonaktif");
+        return;
+    }
+
+    enc_ok = true;
+    ESP_LOGI(TAG, "Encoder ready");
+}
+
+// ==========================================
+void odom_update(float dt)
+{
+    if (!enc_ok || dt <= 0.0f)
+        return;
+
+    for (int i = 0; i < 2; i++)
+    {
+        enc_t *e = &enc[i];
+        int count;
+
+        pcnt_unit_get_count(e->unit, &count);
+
+        float d_mm = (count - e->last_count) * MM_PER_COUNT;
+        e->last_count = count;
+
+        e->dist  += d_mm;
+        e->speed += SPEED_LPF * (d_mm / dt - e->speed);
+    }
+
+    float avg = (enc[MOTOR_LEFT].dist + enc[MOTOR_RIGHT].dist) * 0.5f;
+    distance_mm = (int32_t)(avg - dist_base);
+
+    // PCNT jalan tanpa encoder terpasang = count diam di 0
+    if (!enc_active &&
+        abs(enc[MOTOR_LEFT].last_count)  >= ACTIVE_COUNTS &&
+        abs(enc[MOTOR_RIGHT].last_count) >= ACTIVE_COUNTS)
+    {
+        enc_active = true;
+        ESP_LOGI(TAG, "Encoder aktif");
+    }
+}
+
+bool odom_ok(void)
+{
+    return enc_ok;
+}
+
+bool odom_active(void)
+{
+    return enc_active;
+}
+
+float odom_speed_mm_s(motor_wheel_t wheel)
+{
+    return enc[wheel].speed;
+}
+
+int32_t odom_distance_mm(void)
+{
+    return distance_mm;
+}
+
+void odom_reset_distance(void)
+{
+    dist_base   = (enc[MOTOR_LEFT].dist + enc[MOTOR_RIGHT].dist) * 0.5f;
+    distance_mm = 0;
+}
@@ -0,0 +1,22 @@
+#ifndef ODOM_H
+#define ODOM_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "motor.h"
+
+/* ===== CONFIG ===== */
+#define ODOM_MAX_SPEED_MM_S  800   // kecepatan roda pada PWM_MAX (untuk skala perintah)
+
+void    odom_init(void);
+
+/* dipanggil tiap tick kontrol, dt dalam detik */
+void    odom_update(float dt);
+
+bool    odom_ok(void);       // PCNT siap
+bool    odom_active(void);   // count encoder sudah terlihat saat roda berputar
+float   odom_speed_mm_s(motor_wheel_t wheel);
+int32_t odom_distance_mm(void);    // kumulatif, rata-rata 2 roda
+void    odom_reset_distance(void);
+
+#endif
@@ -0,0 +1,104 @@
+#include "pid.h"
+
+#include <math.h>
+
+static float clampf(float v, float lo, float hi)
+{
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+// ==========================================
+void pid_init(pid_ctrl_t *pid, pid_gains_t gains,
+              float out_min, float out_max)
+{
+    pid->gains     = gains;
+    pid->d_tau     = 0.0f;
+    pid->i_limit   = out_max;
+    pid->out_min   = out_min;
+    pid->out_max   = out_max;
+    pid->sched     = 0;
+    pid->sched_len = 0;
+
+    pid_reset(pid);
+}
+
+void pid_reset(pid_ctrl_t *pid)
+{
+    pid->integral   = 0.0f;
+    pid->prev_error = 0.0f;
+    pid->d_filt     = 0.0f;
+    pid->first      = true;
+}
+
+void pid_set_schedule(pid_ctrl_t *pid, const pid_sched_t *sched, int len)
+{
+    pid->sched     = sched;
+    pid->sched_len = len;
+}
+
+// ==========================================
+// Pilih gain dari tabel (urut naik menurut upto).
+// Integral disimpan setelah dikali ki -> ganti gain tanpa lonjakan.
+// ==========================================
+void pid_schedule(pid_ctrl_t *pid, float x)
+{
+    if (!pid->sched || pid->sched_len <= 0)
+        return;
+
+    x = fabsf(x);
+
+    for (int i = 0; i < pid->sched_len; i++)
+    {
+        if (x <= pid->sched[i].upto)
+        {
+            pid->gains = pid->sched[i].gains;
+            return;
+        }
+    }
+
+    pid->gains = pid->sched[pid->sched_len - 1].gains;
+}
+
+// ==========================================
+float pid_update(pid_ctrl_t *pid, float error, float dt)
+{
+    if (dt <= 0.0f)
+        dt = 1e-3f;
+
+    /* P */
+    float p = pid->gains.kp * error;
+
+    /* D: derivative error + low-pass orde 1 */
+    float d = 0.0f;
+    if (!pid->first)
+    {
+        float d_raw = (error - pid->prev_error) / dt;
+
+        if (pid->d_tau > 0.0f)
+            pid->d_filt += (dt / (pid->d_tau + dt)) * (d_raw - pid->d_filt);
+        else
+            pid->d_filt = d_raw;
+
+        d = pid->gains.kd * pid->d_filt;
+    }
+    pid->prev_error = error;
+    pid->first      = false;
+
+    /* I: clamp + stop integrasi saat output saturasi ke arah yang sama */
+    float i_prev = pid->integral;
+    pid->integral = clampf(pid->integral + pid->gains.ki * error * dt,
+                           -pid->i_limit, pid->i_limit);
+
+    float out = p + pid->integral + d;
+
+    if ((out > pid->out_max && error > 0.0f) ||
+        (out < pid->out_min && error < 0.0f))
+    {
+        pid->integral = i_prev;
+        out = p + pid->integral + d;
+    }
+
+    return clampf(out, pid->out_min, pid->out_max);
+}
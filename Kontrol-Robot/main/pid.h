@@ -0,0 +1,43 @@
+#ifndef PID_H
+#define PID_H
+
+#include <stdbool.h>
+
+/* ===== GAIN ===== */
+typedef struct {
+    float kp;
+    float ki;   // per detik
+    float kd;   // detik
+} pid_gains_t;
+
+/* Baris tabel gain scheduling: dipakai jika |x| <= upto */
+typedef struct {
+    float       upto;
+    pid_gains_t gains;
+} pid_sched_t;
+
+typedef struct {
+    /* config */
+    pid_gains_t        gains;
+    float              d_tau;      // konstanta waktu LPF derivative (s), 0 = tanpa filter
+    float              i_limit;    // clamp kontribusi integral (unit output)
+    float              out_min;
+    float              out_max;
+    const pid_sched_t *sched;
+    int                sched_len;
+
+    /* state */
+    float integral;    // sudah dikali ki
+    float prev_error;
+    float d_filt;
+    bool  first;
+} pid_ctrl_t;
+
+void  pid_init(pid_ctrl_t *pid, pid_gains_t gains,
+               float out_min, float out_max);
+void  pid_reset(pid_ctrl_t *pid);
+void  pid_set_schedule(pid_ctrl_t *pid, const pid_sched_t *sched, int len);
+void  pid_schedule(pid_ctrl_t *pid, float x);
+float pid_update(pid_ctrl_t *pid, float error, float dt);
+
+#endif
@@ -2,9 +2,29 @@
 #include "driver/gpio.h"
 #include "esp_timer.h"
 #include "esp_rom_sys.h"
+#include "esp_log.h"
+#include "nvs.h"
+
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+/* jalur baca: ISR capture, atau bundle dedicated GPIO, atau polling.
+ * Bundle hanya dibangun/dialokasikan jika ISR capture mati. */
+#define QTR_READ_BUNDLE  (!QTR_USE_ISR_CAPTURE && QTR_USE_DEDIC_GPIO)
+
+#if QTR_READ_BUNDLE
+#include "driver/dedic_gpio.h"
+#include "esp_cpu.h"
+#endif
 
 #define TIMEOUT_US 3000
 
+/* ===== KALIBRASI ===== */
+#define CAL_NVS_NS       "qtr"
+#define CAL_NVS_KEY      "cal"
+#define CAL_MIN_RANGE    100    // us, max-min minimal agar channel dianggap valid
+#define CAL_MIN_TIMEOUT  500    // us, batas bawah timeout adaptif
+
 // ================= PIN QTR =================
 static const gpio_num_t qtr_pins[QTR_SENSOR_COUNT] = {
     GPIO_NUM_38,
@@ -17,9 +37,129 @@ static const gpio_num_t qtr_pins[QTR_SENSOR_COUNT] = {
     GPIO_NUM_6
 };
 
+#define QTR_ALL_MASK ((1u << QTR_SENSOR_COUNT) - 1)
+
 // buffer internal
 static uint32_t sensor_values[QTR_SENSOR_COUNT];
 
+static const char *TAG = "QTR";
+
+// timeout aktif: TIMEOUT_US, atau turun mengikuti max hasil kalibrasi
+static uint32_t read_timeout_us = TIMEOUT_US;
+
+typedef struct {
+    uint16_t min[QTR_SENSOR_COUNT];
+    uint16_t max[QTR_SENSOR_COUNT];
+} qtr_cal_t;
+
+static qtr_cal_t qtr_cal;
+static bool      qtr_calibrated = false;
+
+#if QTR_READ_BUNDLE
+
+/*
+ * Bundle input-only: bit i = level qtr_pins[i].
+ * Dedicated GPIO terikat ke core pemanggil qtr_init(),
+ * jadi qtr_read_raw() harus dipanggil dari task yang sama (core 1).
+ */
+static dedic_gpio_bundle_handle_t qtr_bundle = NULL;
+#endif
+
+#if QTR_USE_ISR_CAPTURE
+/*
+ * Mode ISR: tiap falling edge di-timestamp oleh ISR,
+ * frame selesai -> frame_sem. Channel yang belum turun
+ * saat TIMEOUT_US diisi oleh one-shot esp_timer.
+ */
+static SemaphoreHandle_t  frame_sem;
+static esp_timer_handle_t frame_timer;
+static portMUX_TYPE       frame_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static volatile uint32_t frame_pending;
+static volatile int64_t  frame_start;
+static volatile bool     frame_done = true;
+
+static void qtr_edge_isr(void *arg)
+{
+    int i = (int)(intptr_t)arg;
+    int64_t now = esp_timer_get_time();
+    BaseType_t woken = pdFALSE;
+
+    portENTER_CRITICAL_ISR(&frame_lock);
+
+    if (!frame_done && (frame_pending & (1u << i)))
+    {
+        sensor_values[i] = (uint32_t)(now - frame_start);
+        frame_pending &= ~(1u << i);
+
+        if (frame_pending == 0)
+        {
+            frame_done = true;
+            xSemaphoreGiveFromISR(frame_sem, &woken);
+        }
+    }
+
+    portEXIT_CRITICAL_ISR(&frame_lock);
+
+    if (woken)
+        portYIELD_FROM_ISR(woken);
+}
+
+static void qtr_timeout_cb(void *arg)
+{
+    bool give = false;
+
+    portENTER_CRITICAL(&frame_lock);
+
+    if (!frame_done)
+    {
+        // sisa channel = gelap penuh
+        for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+            if (frame_pending & (1u << i))
+                sensor_values[i] = read_timeout_us;
+
+        frame_pending = 0;
+        frame_done = true;
+        give = true;
+    }
+
+    portEXIT_CRITICAL(&frame_lock);
+
+    if (give)
+        xSemaphoreGive(frame_sem);
+}
+
+static void qtr_isr_init(void)
+{
+    frame_sem = xSemaphoreCreateBinary();
+
+    esp_timer_create_args_t targs = {
+        .callback = qtr_timeout_cb,
+        .name     = "qtr_timeout",
+    };
+    esp_timer_create(&targs, &frame_timer);
+
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE)
+        ESP_LOGE(TAG, "ISR service gagal: %s", esp_err_to_name(err));
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        gpio_set_intr_type(qtr_pins[i], GPIO_INTR_NEGEDGE);
+        gpio_intr_disable(qtr_pins[i]);
+        gpio_isr_handler_add(qtr_pins[i], qtr_edge_isr, (void *)(intptr_t)i);
+    }
+}
+
+static void qtr_frame_complete(void)
+{
+    esp_timer_stop(frame_timer);
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        gpio_intr_disable(qtr_pins[i]);
+}
+#endif
+
 // ==========================================
 void qtr_init(void)
 {
@@ -29,15 +169,36 @@ void qtr_init(void)
         gpio_set_direction(qtr_pins[i], GPIO_MODE_OUTPUT);
         gpio_set_level(qtr_pins[i], 0);
     }
+
+#if QTR_USE_ISR_CAPTURE
+    qtr_isr_init();
+#elif QTR_USE_DEDIC_GPIO
+    if (qtr_bundle)
+        dedic_gpio_del_bundle(qtr_bundle);
+
+    int pins[QTR_SENSOR_COUNT];
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        pins[i] = qtr_pins[i];
+
+    dedic_gpio_bundle_config_t cfg = {
+        .gpio_array = pins,
+        .array_size = QTR_SENSOR_COUNT,
+        .flags = {
+            .in_en = 1,
+        },
+    };
+
+    if (dedic_gpio_new_bundle(&cfg, &qtr_bundle) != ESP_OK)
+    {
+        ESP_LOGW(TAG, "Dedicated GPIO gagal, pakai gpio_get_level");
+        qtr_bundle = NULL;
+    }
+#endif
 }
 
 // ==========================================
-void qtr_read_raw(uint32_t *values)
+static void qtr_charge(void)
 {
-    // reset buffer
-    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
-        sensor_values[i] = 0;
-
     // 1. charge capacitor
     for (int i = 0; i < QTR_SENSOR_COUNT; i++)
     {
@@ -50,6 +211,137 @@ void qtr_read_raw(uint32_t *values)
     // 2. set input (discharge)
     for (int i = 0; i < QTR_SENSOR_COUNT; i++)
         gpio_set_direction(qtr_pins[i], GPIO_MODE_INPUT);
+}
+
+#if QTR_READ_BUNDLE
+// ==========================================
+// 1 sample = 1 baca register (8 bit),
+// waktu dari cycle counter (tanpa esp_timer di loop)
+// ==========================================
+static void qtr_read_bundle(void)
+{
+    const uint32_t ticks_per_us = esp_rom_get_cpu_ticks_per_us();
+    const uint32_t timeout_cyc  = read_timeout_us * ticks_per_us;
+
+    uint32_t pending = QTR_ALL_MASK;
+
+    qtr_charge();
+
+    uint32_t start = esp_cpu_get_cycle_count();
+
+    while (pending)
+    {
+        uint32_t level   = dedic_gpio_bundle_read_in(qtr_bundle);
+        uint32_t elapsed = esp_cpu_get_cycle_count() - start;
+        uint32_t fell    = pending & ~level;
+
+        if (fell)
+        {
+            uint32_t t_us = elapsed / ticks_per_us;
+
+            pending &= ~fell;
+            while (fell)
+            {
+                int i = __builtin_ctz(fell);
+                sensor_values[i] = t_us;
+                fell &= fell - 1;
+            }
+        }
+
+        if (elapsed >= timeout_cyc)
+            break;
+    }
+
+    // sisa channel = gelap penuh
+    while (pending)
+    {
+        int i = __builtin_ctz(pending);
+        sensor_values[i] = read_timeout_us;
+        pending &= pending - 1;
+    }
+}
+#endif
+
+#if QTR_USE_ISR_CAPTURE
+// ==========================================
+// Mulai 1 frame (non-blocking)
+// ==========================================
+void qtr_read_start(void)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        gpio_intr_disable(qtr_pins[i]);
+
+    xSemaphoreTake(frame_sem, 0);   // buang frame lama
+
+    qtr_charge();
+
+    portENTER_CRITICAL(&frame_lock);
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        sensor_values[i] = 0;
+    frame_pending = QTR_ALL_MASK;
+    frame_done    = false;
+    frame_start   = esp_timer_get_time();
+    portEXIT_CRITICAL(&frame_lock);
+
+    esp_timer_start_once(frame_timer, read_timeout_us);
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        gpio_intr_enable(qtr_pins[i]);
+
+    // channel yang sudah LOW sebelum interrupt aktif (edge terlewat)
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        if (gpio_get_level(qtr_pins[i]) != 0)
+            continue;
+
+        bool give = false;
+        int64_t now = esp_timer_get_time();
+
+        portENTER_CRITICAL(&frame_lock);
+        if (!frame_done && (frame_pending & (1u << i)))
+        {
+            sensor_values[i] = (uint32_t)(now - frame_start);
+            frame_pending &= ~(1u << i);
+            if (frame_pending == 0)
+            {
+                frame_done = true;
+                give = true;
+            }
+        }
+        portEXIT_CRITICAL(&frame_lock);
+
+        if (give)
+            xSemaphoreGive(frame_sem);
+    }
+}
+
+// ==========================================
+// Tunggu frame tanpa spin. false = timeout, values tidak diubah.
+// Blok N tick selesai di interrupt tick ke-N: tick pertama bisa
+// tinggal beberapa us (100 Hz: pdMS_TO_TICKS(4) = 0), jadi +2 tick
+// ==========================================
+bool qtr_read_wait(uint32_t *values, uint32_t timeout_ms)
+{
+    bool ok = xSemaphoreTake(frame_sem, pdMS_TO_TICKS(timeout_ms) + 2) == pdTRUE;
+
+    qtr_frame_complete();
+
+    if (!ok)
+        return false;
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        values[i] = sensor_values[i];
+    return true;
+}
+#endif
+
+#if !QTR_USE_ISR_CAPTURE
+// ==========================================
+// polling gpio_get_level per pin (tanpa bundle / bundle gagal)
+// ==========================================
+static void qtr_read_poll(void)
+{
+    qtr_charge();
 
     uint64_t start = esp_timer_get_time();
 
@@ -65,43 +357,284 @@ void qtr_read_raw(uint32_t *values)
             {
                 if (gpio_get_level(qtr_pins[i]) == 0)
                     sensor_values[i] = elapsed;
-                else if (elapsed >= TIMEOUT_US)
-                    sensor_values[i] = TIMEOUT_US;
+                else if (elapsed >= read_timeout_us)
+                    sensor_values[i] = read_timeout_us;
                 else
                     done = 0;
             }
         }
 
-        if (done || elapsed >= TIMEOUT_US)
+        if (done || elapsed >= read_timeout_us)
             break;
     }
+}
+#endif
+
+// ==========================================
+// false = frame tidak selesai (hanya mode ISR), values tidak diubah
+// ==========================================
+bool qtr_read_raw(uint32_t *values)
+{
+#if QTR_USE_ISR_CAPTURE
+    // one-shot esp_timer selalu menutup frame setelah read_timeout_us
+    qtr_read_start();
+    return qtr_read_wait(values, TIMEOUT_US / 1000 + 1);
+#else
+    // reset buffer
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        sensor_values[i] = 0;
+
+#if QTR_READ_BUNDLE
+    if (qtr_bundle)
+        qtr_read_bundle();
+    else
+#endif
+        qtr_read_poll();
 
     for (int i = 0; i < QTR_SENSOR_COUNT; i++)
         values[i] = sensor_values[i];
+    return true;
+#endif
 }
 
 // ==========================================
-// POSISI GARIS (0 – 7000)
-// hitam = nilai besar
+// KALIBRASI (min/max per channel)
 // ==========================================
-int qtr_read_position(void)
+static void qtr_update_timeout(void)
+{
+    if (!qtr_calibrated)
+    {
+        read_timeout_us = TIMEOUT_US;
+        return;
+    }
+
+    uint32_t max = 0;
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        if (qtr_cal.max[i] > max)
+            max = qtr_cal.max[i];
+
+    // margin 1/8 di atas channel paling gelap
+    max += max / 8;
+
+    if (max < CAL_MIN_TIMEOUT) max = CAL_MIN_TIMEOUT;
+    if (max > TIMEOUT_US)      max = TIMEOUT_US;
+
+    read_timeout_us = max;
+}
+
+static bool qtr_cal_valid(const qtr_cal_t *cal)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+        if (cal->max[i] < cal->min[i] + CAL_MIN_RANGE)
+            return false;
+    return true;
+}
+
+void qtr_calibrate_reset(void)
+{
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        qtr_cal.min[i] = TIMEOUT_US;
+        qtr_cal.max[i] = 0;
+    }
+
+    qtr_calibrated = false;
+    qtr_update_timeout();
+}
+
+// 1 kali baca, update min/max. Robot disapukan di atas garis.
+// frame gagal dilewati: jangan dorong max ke TIMEOUT_US
+bool qtr_calibrate(void)
 {
     uint32_t values[QTR_SENSOR_COUNT];
-    qtr_read_raw(values);
 
-    uint32_t weighted_sum = 0;
-    uint32_t sum = 0;
+    read_timeout_us = TIMEOUT_US;
+    if (!qtr_read_raw(values))
+        return false;
 
     for (int i = 0; i < QTR_SENSOR_COUNT; i++)
     {
-        uint32_t v = values[i];
-        weighted_sum += v * (i * 1000);
-        sum += v;
+        if (values[i] < qtr_cal.min[i]) qtr_cal.min[i] = values[i];
+        if (values[i] > qtr_cal.max[i]) qtr_cal.max[i] = values[i];
+    }
+    return true;
+}
+
+bool qtr_calibration_save(void)
+{
+    if (!qtr_cal_valid(&qtr_cal))
+    {
+        ESP_LOGW(TAG, "Kalibrasi tidak valid, tidak disimpan");
+        return false;
+    }
+
+    nvs_handle_t nvs;
+    if (nvs_open(CAL_NVS_NS, NVS_READWRITE, &nvs) != ESP_OK)
+        return false;
+
+    esp_err_t err = nvs_set_blob(nvs, CAL_NVS_KEY, &qtr_cal, sizeof(qtr_cal));
+    if (err == ESP_OK)
+        err = nvs_commit(nvs);
+    nvs_close(nvs);
+
+    if (err != ESP_OK)
+    {
+        ESP_LOGE(TAG, "Simpan kalibrasi gagal: %s", esp_err_to_name(err));
+        return false;
     }
 
-    if (sum == 0)
-        return -1;   // garis hilang
+    qtr_calibrated = true;
+    qtr_update_timeout();
 
-    return weighted_sum / sum;
+    ESP_LOGI(TAG, "Kalibrasi disimpan, timeout %lu us",
+             (unsigned long)read_timeout_us);
+    return true;
 }
 
+bool qtr_calibration_load(void)
+{
+    qtr_cal_t cal;
+    size_t len = sizeof(cal);
+    nvs_handle_t nvs;
+
+    if (nvs_open(CAL_NVS_NS, NVS_READONLY, &nvs) != ESP_OK)
+        return false;
+
+    esp_err_t err = nvs_get_blob(nvs, CAL_NVS_KEY, &cal, &len);
+    nvs_close(nvs);
+
+    if (err != ESP_OK || len != sizeof(cal) || !qtr_cal_valid(&cal))
+        return false;
+
+    qtr_cal = cal;
+    qtr_calibrated = true;
+    qtr_update_timeout();
+
+    ESP_LOGI(TAG, "Kalibrasi dimuat, timeout %lu us",
+             (unsigned long)read_timeout_us);
+    return true;
+}
+
+bool qtr_is_calibrated(void)
+{
+    return qtr_calibrated;
+}
+
+// ==========================================
+// 0 (putih) – QTR_CAL_MAX (hitam)
+// tanpa kalibrasi: range 0..TIMEOUT_US
+// false = frame gagal, values tidak diubah
+// ==========================================
+bool qtr_read_calibrated(uint16_t *values)
+{
+    uint32_t raw[QTR_SENSOR_COUNT];
+    if (!qtr_read_raw(raw))
+        return false;
+
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        uint32_t lo = qtr_calibrated ? qtr_cal.min[i] : 0;
+        uint32_t hi = qtr_calibrated ? qtr_cal.max[i] : TIMEOUT_US;
+
+        if (raw[i] <= lo)
+            values[i] = 0;
+        else if (raw[i] >= hi)
+            values[i] = QTR_CAL_MAX;
+        else
+            values[i] = (raw[i] - lo) * QTR_CAL_MAX / (hi - lo);
+    }
+    return true;
+}
+
+// ==========================================
+// ESTIMASI POSISI (integer, 0 – 7000)
+// peak channel + fit parabola 3 titik,
+// di bawah QTR_LINE_THRESHOLD = background.
+// Gelap merata (confidence < QTR_MIN_CONFIDENCE):
+// peak tidak bermakna -> QTR_CENTER seperti centroid lama
+// ==========================================
+bool qtr_estimate_line(const uint16_t *values, qtr_line_t *line)
+{
+    int peak = 0;
+
+    for (int i = 1; i < QTR_SENSOR_COUNT; i++)
+        if (values[i] > values[peak])
+            peak = i;
+
+    int p = values[peak];
+
+    if (p < QTR_LINE_THRESHOLD)
+    {
+        line->position   = -1;   // garis hilang
+        line->confidence = 0;
+        return false;
+    }
+
+    // di luar sensor dianggap putih
+    int l = (peak > 0)                    ? values[peak - 1] : 0;
+    int r = (peak < QTR_SENSOR_COUNT - 1) ? values[peak + 1] : 0;
+
+    // puncak parabola: (l - r) / (2 * (l - 2p + r)), skala 1000
+    int den    = l - 2 * p + r;
+    int offset = 0;
+
+    if (den != 0)
+        offset = (l - r) * 500 / den;
+
+    if (offset < -500) offset = -500;
+    if (offset >  500) offset =  500;
+
+    // background = rata-rata channel di luar peak ± 1
+    int bg_sum = 0, bg_n = 0;
+    for (int i = 0; i < QTR_SENSOR_COUNT; i++)
+    {
+        if (i >= peak - 1 && i <= peak + 1)
+            continue;
+        bg_sum += values[i];
+        bg_n++;
+    }
+
+    int conf = p - (bg_n ? bg_sum / bg_n : 0);
+    if (conf < 0) conf = 0;
+
+    line->confidence = conf;
+
+    if (conf < QTR_MIN_CONFIDENCE)
+    {
+        line->position = QTR_CENTER;
+        return true;
+    }
+
+    line->position = peak * 1000 + offset;
+
+    if (line->position < 0)
+        line->position = 0;
+    if (line->position > (QTR_SENSOR_COUNT - 1) * 1000)
+        line->position = (QTR_SENSOR_COUNT - 1) * 1000;
+
+    return true;
+}
+
+// false = frame sensor gagal (line tidak diubah), bukan garis hilang
+bool qtr_read_line(qtr_line_t *line)
+{
+    uint16_t values[QTR_SENSOR_COUNT];
+    if (!qtr_read_calibrated(values))
+        return false;
+
+    qtr_estimate_line(values, line);
+    return true;
+}
+
+// ==========================================
+// POSISI GARIS (0 – 7000)
+// hitam = nilai besar, -1 = garis hilang
+// ==========================================
+int qtr_read_position(void)
+{
+    qtr_line_t line;
+    if (!qtr_read_line(&line))
+        return -1;
+
+    return line.position;
+}
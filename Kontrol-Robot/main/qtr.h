@@ -1,9 +1,45 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 
 #define QTR_SENSOR_COUNT 8
+#define QTR_CAL_MAX      1000   // skala qtr_read_calibrated()
+
+#define QTR_LINE_THRESHOLD  200 // peak di bawah ini = garis hilang
+#define QTR_MIN_CONFIDENCE  150 // peak - background di bawah ini = gelap merata (persimpangan)
+#define QTR_CENTER          ((QTR_SENSOR_COUNT - 1) * 500)
+
+/* ===== HASIL ESTIMASI GARIS ===== */
+typedef struct {
+    int position;     // 0 – 7000, -1 = garis hilang, QTR_CENTER jika confidence rendah
+    int confidence;   // 0 – QTR_CAL_MAX (peak - background)
+} qtr_line_t;
+
+/* ===== CONFIG (bisa di-override -D, mis. test host) =====
+ * ISR capture aktif -> bundle tidak dipakai (dan tidak dialokasikan) */
+#ifndef QTR_USE_DEDIC_GPIO
+#define QTR_USE_DEDIC_GPIO  1   // 1 = baca 8 pin sekaligus (dedicated GPIO), 0 = gpio_get_level per pin
+#endif
+#ifndef QTR_USE_ISR_CAPTURE
+#define QTR_USE_ISR_CAPTURE 1   // 1 = timestamp edge di ISR (task tidak spin), 0 = polling
+#endif
 
 void qtr_init(void);
-void qtr_read_raw(uint32_t *values);
+bool qtr_read_raw(uint32_t *values);         // false = frame gagal
 int  qtr_read_position(void);
+bool qtr_read_line(qtr_line_t *line);        // false = frame gagal, true = lihat position
+bool qtr_estimate_line(const uint16_t *values, qtr_line_t *line);
+
+/* ===== KALIBRASI (disimpan di NVS) ===== */
+void qtr_calibrate_reset(void);
+bool qtr_calibrate(void);
+bool qtr_calibration_save(void);
+bool qtr_calibration_load(void);
+bool qtr_is_calibrated(void);
+bool qtr_read_calibrated(uint16_t *values);
 
+#if QTR_USE_ISR_CAPTURE
+/* Non-blocking: mulai charge/discharge, lalu ambil frame 8 channel */
+void qtr_read_start(void);
+bool qtr_read_wait(uint32_t *values, uint32_t timeout_ms);
+#endif
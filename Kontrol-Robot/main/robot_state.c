@@ -1,4 +1,168 @@
 #include "robot_state.h"
+#include <stdatomic.h>
 
-volatile robot_state_t robot_state = ROBOT_RUN;
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "esp_log.h"
 
+#define TAG "STATE"
+
+#define EVQ_LEN    16               // harus pangkat 2
+#define EVQ_MASK   (EVQ_LEN - 1)
+
+/* ================= ANTRIAN EVENT (MPSC, bounded) =================
+ * tiap sel punya nomor urut: produsen klaim slot dengan CAS pada head,
+ * konsumen tunggal membaca tanpa CAS.
+ */
+typedef struct {
+    atomic_uint   seq;
+    robot_event_t ev;
+    int           arg;
+} evq_cell_t;
+
+static evq_cell_t  evq[EVQ_LEN];
+static atomic_uint evq_head;        // produsen
+static unsigned    evq_tail;        // hanya robot_state_task
+
+static atomic_int   state = ROBOT_RUN;
+static _Atomic(TaskHandle_t) owner;    // NULL sampai robot_state_task jalan
+
+static const char *state_name[] = { "RUN", "STOP", "ERROR" };
+static const char *event_name[EV_COUNT] = {
+    "OBSTACLE", "CAPTURE_DONE", "CAPTURE_FAILED", "UPLOAD_DONE", "LINE_LOST",
+    "RESUME"
+};
+
+/* ================= INIT ================= */
+void robot_state_init(robot_state_t initial)
+{
+    for (unsigned i = 0; i < EVQ_LEN; i++)
+        atomic_init(&evq[i].seq, i);
+
+    atomic_init(&evq_head, 0);
+    evq_tail = 0;
+
+    atomic_store_explicit(&state, initial, memory_order_release);
+}
+
+robot_state_t robot_state_get(void)
+{
+    return (robot_state_t)atomic_load_explicit(&state, memory_order_acquire);
+}
+
+/* ================= PRODUSEN ================= */
+bool robot_event_post(robot_event_t ev, int arg)
+{
+    unsigned pos = atomic_load_explicit(&evq_head, memory_order_relaxed);
+    evq_cell_t *cell;
+
+    while (1)
+    {
+        cell = &evq[pos & EVQ_MASK];
+        unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+        int diff = (int)(seq - pos);
+
+        if (diff == 0)
+        {
+            // slot kosong: klaim
+            if (atomic_compare_exchange_weak_explicit(&evq_head, &pos, pos + 1,
+                                                      memory_order_relaxed,
+                                                      memory_order_relaxed))
+                break;
+        }
+        else if (diff < 0)
+        {
+            ESP_LOGE(TAG, "Event queue full, %s dropped", event_name[ev]);
+            return false;
+        }
+        else
+        {
+            pos = atomic_load_explicit(&evq_head, memory_order_relaxed);
+        }
+    }
+
+    cell->ev  = ev;
+    cell->arg = arg;
+    atomic_store_explicit(&cell->seq, pos + 1, memory_order_release);
+
+    // belum jalan: event tetap antri, diproses saat task mulai
+    TaskHandle_t t = atomic_load(&owner);
+    if (t)
+        xTaskNotifyGive(t);
+
+    return true;
+}
+
+/* ================= KONSUMEN ================= */
+static bool evq_pop(robot_event_t *ev, int *arg)
+{
+    evq_cell_t *cell = &evq[evq_tail & EVQ_MASK];
+    unsigned seq = atomic_load_explicit(&cell->seq, memory_order_acquire);
+
+    if ((int)(seq - (evq_tail + 1)) < 0)
+        return false;
+
+    *ev  = cell->ev;
+    *arg = cell->arg;
+    atomic_store_explicit(&cell->seq, evq_tail + EVQ_LEN, memory_order_release);
+    evq_tail++;
+    return true;
+}
+
+/* ================= TRANSISI ================= */
+// return state baru; sama dengan cur = event diabaikan
+static robot_state_t transition(robot_state_t cur, robot_event_t ev)
+{
+    switch (cur)
+    {
+        case ROBOT_RUN:
+            if (ev == EV_OBSTACLE)       return ROBOT_STOP;
+            if (ev == EV_LINE_LOST)      return ROBOT_ERROR;
+            break;
+
+        case ROBOT_STOP:
+            if (ev == EV_CAPTURE_DONE)   return ROBOT_RUN;
+            if (ev == EV_CAPTURE_FAILED) return ROBOT_ERROR;
+            break;
+
+        case ROBOT_ERROR:
+            if (ev == EV_RESUME)         return ROBOT_RUN;
+            break;      // selain itu hanya reboot
+
+        default:
+            break;
+    }
+
+    return cur;
+}
+
+void robot_state_task(void *pv)
+{
+    robot_event_t ev;
+    int arg;
+
+    // publish sebelum menguras: event sebelum ini sudah di antrian
+    atomic_store(&owner, xTaskGetCurrentTaskHandle());
+
+    while (1)
+    {
+        while (evq_pop(&ev, &arg))
+        {
+            robot_state_t cur  = robot_state_get();
+            robot_state_t next = transition(cur, ev);
+
+            if (next != cur)
+            {
+                atomic_store_explicit(&state, next, memory_order_release);
+                ESP_LOGI(TAG, "%s -> %s (%s %d)",
+                         state_name[cur], state_name[next], event_name[ev], arg);
+            }
+            else if (ev != EV_UPLOAD_DONE)
+            {
+                ESP_LOGW(TAG, "%s ignored in %s", event_name[ev], state_name[cur]);
+            }
+        }
+
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    }
+}
@@ -1,13 +1,42 @@
 #ifndef ROBOT_STATE_H
 #define ROBOT_STATE_H
 
+#include <stdbool.h>
+
+/* =========================================================
+ *  STATE MACHINE ROBOT
+ *  - state hanya diubah oleh robot_state_task (satu pemilik)
+ *  - task lain mengirim event lewat antrian lock-free (MPSC)
+ *  - pembaca memakai robot_state_get() (atomic load)
+ *  - ERROR hanya keluar lewat EV_RESUME (POST /robot/resume di
+ *    backend, setelah robot diletakkan lagi di garis) atau reboot
+ * ========================================================= */
+
 typedef enum {
     ROBOT_RUN = 0,
     ROBOT_STOP,
     ROBOT_ERROR
 } robot_state_t;
 
-extern volatile robot_state_t robot_state;
+typedef enum {
+    EV_OBSTACLE = 0,     // hcsr: pot di depan        RUN  -> STOP
+    EV_CAPTURE_DONE,     // kamera selesai capture    STOP -> RUN
+    EV_CAPTURE_FAILED,   // kamera tidak menjawab     STOP -> ERROR
+    EV_UPLOAD_DONE,      // backend selesai analisis  (info, tanpa transisi)
+    EV_LINE_LOST,        // linefollow: garis hilang  RUN  -> ERROR
+    EV_RESUME,           // operator (backend, ws)    ERROR -> RUN
+    EV_COUNT
+} robot_event_t;
 
-#endif
+/* sekali di app_main, sebelum task lain dibuat */
+void          robot_state_init(robot_state_t initial);
 
+robot_state_t robot_state_get(void);
+
+/* dari task mana saja, tidak blocking; false jika antrian penuh */
+bool          robot_event_post(robot_event_t ev, int arg);
+
+/* pemilik state: prioritas di atas linefollow, core yang sama */
+void          robot_state_task(void *pv);
+
+#endif
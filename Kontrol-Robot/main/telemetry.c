@@ -0,0 +1,98 @@
+#include "telemetry.h"
+
+#include "freertos/FreeRTOS.h"
+
+#define TELEM_RING   64      // ~2.5 s pada 25 Hz
+
+static telemetry_sample_t ring[TELEM_RING];
+static uint32_t           ring_head;     // total ditulis
+static uint32_t           ring_tail;     // total dibaca
+static portMUX_TYPE       ring_lock = portMUX_INITIALIZER_UNLOCKED;
+
+/* ================= RING ================= */
+void telemetry_record(const telemetry_sample_t *s)
+{
+    portENTER_CRITICAL(&ring_lock);
+
+    ring[ring_head % TELEM_RING] = *s;
+    ring_head++;
+
+    if (ring_head - ring_tail > TELEM_RING)
+        ring_tail = ring_head - TELEM_RING;
+
+    portEXIT_CRITICAL(&ring_lock);
+}
+
+static int ring_pop(telemetry_sample_t *s)
+{
+    int ok = 0;
+
+    portENTER_CRITICAL(&ring_lock);
+    if (ring_tail != ring_head)
+    {
+        *s = ring[ring_tail % TELEM_RING];
+        ring_tail++;
+        ok = 1;
+    }
+    portEXIT_CRITICAL(&ring_lock);
+
+    return ok;
+}
+
+/* ================= ENCODER LE ================= */
+static uint8_t *put_u16(uint8_t *p, uint16_t v)
+{
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+    return p + 2;
+}
+
+static uint8_t *put_u32(uint8_t *p, uint32_t v)
+{
+    p = put_u16(p, v & 0xFFFF);
+    return put_u16(p, v >> 16);
+}
+
+size_t telemetry_encode(uint8_t *buf, size_t cap, uint16_t boot)
+{
+    telemetry_sample_t s;
+    uint32_t t0 = 0;
+    uint16_t count = 0;
+
+    if (cap < TELEM_HDR_SIZE + TELEM_REC_SIZE)
+        return 0;
+
+    uint8_t *p   = buf + TELEM_HDR_SIZE;
+    uint8_t *end = buf + cap;
+
+    while (p + TELEM_REC_SIZE <= end && ring_pop(&s))
+    {
+        if (count == 0)
+            t0 = s.t_ms;
+
+        uint32_t dt = s.t_ms - t0;
+
+        p = put_u16(p, dt > 0xFFFF ? 0xFFFF : dt);
+        p = put_u16(p, (uint16_t)s.pos);
+        p = put_u16(p, (uint16_t)s.left);
+        p = put_u16(p, (uint16_t)s.right);
+        p = put_u16(p, (uint16_t)s.dist_cm);
+        *p++ = s.state;
+        *p++ = 0;
+        count++;
+    }
+
+    if (count == 0)
+        return 0;
+
+    uint8_t *h = buf;
+    *h++ = 'T';
+    *h++ = 'L';
+    *h++ = TELEM_VER;
+    *h++ = TELEM_TYPE_CONTROL;
+    h = put_u16(h, count);
+    h = put_u16(h, boot);
+    put_u32(h, t0);
+
+    return p - buf;
+}
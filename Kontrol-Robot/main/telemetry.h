@@ -0,0 +1,52 @@
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* =========================================================
+ *  TELEMETRY BINER (little-endian, skema tetap)
+ *
+ *  header 12 byte:
+ *    u8  magic[2] = 'T','L'
+ *    u8  ver      = TELEM_VER
+ *    u8  type     = TELEM_TYPE_CONTROL
+ *    u16 count    jumlah record
+ *    u16 boot
+ *    u32 t0_ms    uptime record pertama
+ *
+ *  record CONTROL 12 byte:
+ *    u16 dt_ms    offset dari t0_ms
+ *    i16 pos      0..7000, -1 = garis hilang
+ *    i16 left     perintah PWM kiri
+ *    i16 right    perintah PWM kanan
+ *    i16 dist_cm  -1 = tidak ada objek
+ *    u8  state    robot_state_t
+ *    u8  rsv
+ *
+ *  JANGAN DIUBAH tanpa menaikkan TELEM_VER (decoder backend ikut).
+ * ========================================================= */
+
+#define TELEM_VER            1
+#define TELEM_TYPE_CONTROL   1
+
+#define TELEM_HDR_SIZE       12
+#define TELEM_REC_SIZE       12
+
+typedef struct {
+    uint32_t t_ms;
+    int16_t  pos;
+    int16_t  left;
+    int16_t  right;
+    int16_t  dist_cm;
+    uint8_t  state;
+} telemetry_sample_t;
+
+/* dari loop kontrol, tidak blocking; ring penuh -> sampel tertua ditimpa */
+void   telemetry_record(const telemetry_sample_t *s);
+
+/* kuras ring ke satu frame di buf milik pemanggil (tanpa alokasi);
+ * return panjang frame, 0 jika tidak ada sampel */
+size_t telemetry_encode(uint8_t *buf, size_t cap, uint16_t boot);
+
+#endif
@@ -1,169 +1,464 @@
+#include <stdio.h>
+#include <stdarg.h>
 #include <string.h>
+#include <stdatomic.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/queue.h"
 
 #include "esp_log.h"
-#include "esp_wifi.h"
-#include "esp_event.h"
-#include "esp_netif.h"
-#include "nvs_flash.h"
 #include "esp_http_client.h"
+#include "esp_timer.h"
 
 #include "wifi_http.h"
+#include "http_pool.h"
 #include "robot_state.h"
+#include "conn.h"
+#include "journal.h"
+#include "telemetry.h"
+#include "ws_link.h"
 
 #define TAG "WIFI_HTTP"
 
-#define WIFI_SSID "vivo Y33S"
-#define WIFI_PASS "arduinouno"
-
 /* ===== ENDPOINT ===== */
-#define POST_DHT_URL   "http://leafiot.ksmiotupnvj.com:8000/sensor/dht"
+#define POST_DHT_URL   "http://leafiot.ksmiotupnvj.com:8000/sensor/dht/batch"
 #define POST_POT_URL   "http://leafiot.ksmiotupnvj.com:8000/pot"
-#define CHECK_UPLOAD   "http://leafiot.ksmiotupnvj.com:8000/chili/upload"
+#define POST_POT_HISTORY_URL "http://leafiot.ksmiotupnvj.com:8000/pot/history"
+
+#define POT_QUEUE_LEN    2
+#define CONN_QUEUE_LEN   4
+#define RESULT_QUEUE_LEN 4
+#define DHT_QUEUE_LEN    4
+
+/* ===== BATCH DHT: kirim tiap N sampel atau T ms, mana yang lebih dulu ===== */
+#define DHT_BATCH_MAX    12     // 12 x 5 s = 1 request / menit
+#define DHT_BATCH_MS     60000
+
+/* ===== TELEMETRY KONTROL (biner, lihat telemetry.h) ===== */
+#define TELEM_PERIOD_MS  1000
+#define TELEM_MAX_REC    64
+
+/*
+ * Tiap producer: xQueueSend lalu xTaskNotifyGive ke wifi_http_task.
+ * Task menguras semua queue, baru tidur di ulTaskNotifyTake:
+ * item yang masuk setelah dikuras selalu menyisakan notifikasi.
+ */
+static QueueHandle_t pot_queue;         // int, dari hcsr
+static QueueHandle_t dht_queue;         // dht_data_t, dari dht_task
+static QueueHandle_t conn_queue;        // conn_event_t dari conn.c
+static QueueHandle_t result_queue;      // ws_result_t dari ws_link.c
+
+static _Atomic(TaskHandle_t) http_task; // NULL sampai task jalan
+
+typedef struct {
+    float    temperature;
+    float    humidity;
+    uint16_t boot;
+    uint32_t seq;        // 0 = sampel langsung, bukan replay journal
+    uint32_t t_ms;       // uptime saat dibaca
+} dht_sample_t;
+
+static dht_sample_t dht_batch[DHT_BATCH_MAX];
+static int          dht_batch_len;
+
+/* buffer JSON statis: tidak ada alokasi per request */
+static char dht_json[1280];
+static char pot_json[128];
+static uint8_t telem_buf[TELEM_HDR_SIZE + TELEM_MAX_REC * TELEM_REC_SIZE];
+static uint32_t telem_last_ms;
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(esp_timer_get_time() / 1000);
+}
 
-extern QueueHandle_t dht_queue;
-QueueHandle_t pot_queue;
+/* ================= JSON APPEND ================= */
+// tambah ke buf[len..]; -1 jika terpotong, dan tetap -1 untuk append berikutnya
+static int json_append(char *buf, size_t size, int len, const char *fmt, ...)
+{
+    if (len < 0)
+        return -1;
 
-static int pot_index = 0;
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf + len, size - len, fmt, ap);
+    va_end(ap);
 
-/* ================= WIFI HANDLER ================= */
-static void wifi_event_handler(void *arg,
-                               esp_event_base_t event_base,
-                               int32_t event_id,
-                               void *event_data)
+    if (n < 0 || (size_t)n >= size - len)
+        return -1;
+    return len + n;
+}
+
+/* ================= HTTP POST DHT (BATCH) ================= */
+// semua sampel harus dari boot yang sama
+static int http_post_dht(const dht_sample_t *s, int n)
 {
-    if (event_id == WIFI_EVENT_STA_START)
-        esp_wifi_connect();
+    uint32_t now  = now_ms();
+    bool     live = (s[0].boot == journal_boot());   // uptime hanya valid di boot ini
+
+    int len = json_append(dht_json, sizeof(dht_json), 0,
+                          "{\"device\":\"esp32cam-01\",\"boot\":%u,\"samples\":[",
+                          s[0].boot);
 
-    else if (event_id == WIFI_EVENT_STA_DISCONNECTED)
-        esp_wifi_connect();
+    for (int i = 0; i < n && len >= 0; i++)
+    {
+        len = json_append(dht_json, sizeof(dht_json), len,
+                          "%s{\"temperature\":%.2f,\"humidity\":%.2f",
+                          i ? "," : "", s[i].temperature, s[i].humidity);
+
+        if (live)
+            len = json_append(dht_json, sizeof(dht_json), len,
+                              ",\"age_ms\":%lu", (unsigned long)(now - s[i].t_ms));
+        if (s[i].seq)
+            len = json_append(dht_json, sizeof(dht_json), len,
+                              ",\"seq\":%lu", (unsigned long)s[i].seq);
+
+        len = json_append(dht_json, sizeof(dht_json), len, "}");
+    }
+
+    len = json_append(dht_json, sizeof(dht_json), len, "]}");
+
+    if (len < 0)
+    {
+        ESP_LOGE(TAG, "DHT batch too large (%d)", n);
+        return 400;     // jangan diulang
+    }
 
-    else if (event_base == IP_EVENT &&
-             event_id == IP_EVENT_STA_GOT_IP)
-        ESP_LOGI(TAG, "WiFi connected");
+    return http_pool_request(HTTP_METHOD_POST, POST_DHT_URL,
+                             "application/json", dht_json, len);
 }
 
-/* ================= HTTP POST DHT ================= */
-static void http_post_dht(dht_data_t *data)
+/* ================= HTTP POST POT ================= */
+static int http_post_pot(int pot)
 {
-    char json[128];
+    int len = snprintf(pot_json, sizeof(pot_json), "{\"pot\":%d}", pot);
 
-    snprintf(json, sizeof(json),
-             "{\"device\":\"esp32cam-01\",\"temperature\":%.2f,\"humidity\":%.2f}",
-             data->temperature, data->humidity);
+    return http_pool_request(HTTP_METHOD_POST, POST_POT_URL,
+                             "application/json", pot_json, len);
+}
 
-    esp_http_client_config_t cfg = {
-        .url = POST_DHT_URL,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 5000,
-    };
+// replay journal: hanya riwayat, current pot di backend tidak berubah
+static int http_post_pot_history(const journal_entry_t *e)
+{
+    int len = json_append(pot_json, sizeof(pot_json), 0,
+                          "{\"device\":\"esp32cam-01\",\"boot\":%u,"
+                          "\"seq\":%lu,\"pot\":%ld",
+                          e->boot, (unsigned long)e->seq, (long)e->v0);
+
+    // uptime hanya valid di boot ini
+    if (e->boot == journal_boot())
+        len = json_append(pot_json, sizeof(pot_json), len, ",\"age_ms\":%lu",
+                          (unsigned long)(now_ms() - e->t_ms));
+
+    len = json_append(pot_json, sizeof(pot_json), len, "}");
+    if (len < 0)
+        return 400;     // tidak mungkin dengan buffer ini; jangan diulang
+
+    return http_pool_request(HTTP_METHOD_POST, POST_POT_HISTORY_URL,
+                             "application/json", pot_json, len);
+}
 
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-    esp_http_client_set_post_field(client, json, strlen(json));
+/* ================= WAKE ================= */
+// sebelum task jalan: notifikasi tidak perlu, putaran pertama menguras queue
+static void http_wake(void)
+{
+    TaskHandle_t t = atomic_load(&http_task);
 
-    esp_http_client_perform(client);
-    esp_http_client_cleanup(client);
+    if (t)
+        xTaskNotifyGive(t);
 }
 
-/* ================= HTTP POST POT ================= */
-static bool http_post_pot(int pot)
+static bool post_and_wake(QueueHandle_t q, const void *item)
 {
-    char json[32];
-    snprintf(json, sizeof(json), "{\"pot\":%d}", pot);
+    if (xQueueSend(q, item, 0) != pdTRUE)
+        return false;
 
-    esp_http_client_config_t cfg = {
-        .url = POST_POT_URL,
-        .method = HTTP_METHOD_POST,
-        .timeout_ms = 5000,
-    };
+    http_wake();
+    return true;
+}
 
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    esp_http_client_set_header(client, "Content-Type", "application/json");
-    esp_http_client_set_post_field(client, json, strlen(json));
+bool wifi_http_post_pot(int pot)
+{
+    return post_and_wake(pot_queue, &pot);
+}
 
-    esp_err_t err = esp_http_client_perform(client);
-    int status = esp_http_client_get_status_code(client);
-    esp_http_client_cleanup(client);
+bool wifi_http_post_dht(const dht_data_t *d)
+{
+    return post_and_wake(dht_queue, d);
+}
 
-    return (err == ESP_OK && status == 200);
+/* ================= CONN CALLBACK ================= */
+// jalan di task event loop: cukup diteruskan ke queue
+static void on_conn_event(conn_event_t evt, void *arg)
+{
+    post_and_wake(conn_queue, &evt);
 }
 
-/* ================= WAIT UPLOAD ================= */
-static bool wait_upload_done(void)
+/* ================= INIT ================= */
+esp_err_t wifi_http_init(void)
 {
-    esp_http_client_config_t cfg = {
-        .url = CHECK_UPLOAD,
-        .method = HTTP_METHOD_GET,
-        .timeout_ms = 5000,
-    };
+    pot_queue    = xQueueCreate(POT_QUEUE_LEN, sizeof(int));
+    dht_queue    = xQueueCreate(DHT_QUEUE_LEN, sizeof(dht_data_t));
+    conn_queue   = xQueueCreate(CONN_QUEUE_LEN, sizeof(conn_event_t));
+    result_queue = xQueueCreate(RESULT_QUEUE_LEN, sizeof(ws_result_t));
+
+    if (!pot_queue || !dht_queue || !conn_queue || !result_queue)
+        return ESP_ERR_NO_MEM;
 
-    esp_http_client_handle_t client = esp_http_client_init(&cfg);
-    esp_err_t err = esp_http_client_perform(client);
-    int status = esp_http_client_get_status_code(client);
-    esp_http_client_cleanup(client);
+    if (ws_link_init(result_queue, http_wake) != ESP_OK)
+        ESP_LOGW(TAG, "WebSocket init failed, HTTP only");
 
-    return (err == ESP_OK && status == 200);
+    // tanpa partisi journal: tetap jalan, data offline tidak disimpan
+    journal_init();
+
+    return conn_register_cb(on_conn_event, NULL);
 }
 
-/* ================= TASK ================= */
-void wifi_http_task(void *pv)
+// status < 0 / 5xx: coba lagi nanti; 4xx: record dibuang agar antrian tidak macet
+static bool send_ok(int status)
 {
-    dht_data_t recv;
-    int pot_event;
+    return status >= 0 && status < 500;
+}
 
-    esp_netif_init();
-    esp_event_loop_create_default();
-    esp_netif_create_default_wifi_sta();
+/* ================= POT ================= */
+// dikirim sebelum capture agar backend tahu pot untuk upload berikutnya
+// false jika tidak terkirim sama sekali (link kemungkinan putus)
+static bool handle_pot(int pot)
+{
+    ESP_LOGI(TAG, "Pot %d detected", pot);
+
+    if (ws_link_send_pot(pot))
+        return true;
 
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_wifi_init(&cfg);
+    // fallback backend lama tanpa /ws/robot
+    return send_ok(http_post_pot(pot));
+}
 
-    esp_event_handler_register(WIFI_EVENT, ESP_EVENT_ANY_ID,
-                               &wifi_event_handler, NULL);
-    esp_event_handler_register(IP_EVENT, IP_EVENT_STA_GOT_IP,
-                               &wifi_event_handler, NULL);
+// push dari backend begitu YOLO selesai, tanpa polling
+static void handle_result(const ws_result_t *r)
+{
+    ESP_LOGI(TAG, "Pot %d analysed: ripe=%d unripe=%d total=%d",
+             r->pot, r->ripe, r->unripe, r->total);
+
+    robot_event_post(EV_UPLOAD_DONE, r->pot);
+}
+
+/* ================= JOURNAL ================= */
+static void journal_dht(const dht_sample_t *d)
+{
+    journal_append(JOURNAL_DHT,
+                   (int32_t)(d->temperature * 100.0f),
+                   (int32_t)(d->humidity * 100.0f));
+}
 
-    wifi_config_t wifi_cfg = {
-        .sta = {
-            .ssid = WIFI_SSID,
-            .password = WIFI_PASS,
+static void journal_pot(int pot)
+{
+    if (journal_ready() && journal_append(JOURNAL_POT, pot, 0) == ESP_OK)
+        ESP_LOGW(TAG, "Pot %d offline, journaled", pot);
+    else
+        ESP_LOGE(TAG, "Pot %d offline, not sent", pot);
+}
+
+// kirim satu putaran tertua; DHT berurutan digabung jadi satu batch
+// false jika gagal (link kemungkinan putus)
+static bool journal_drain_batch(void)
+{
+    static journal_entry_t ent[DHT_BATCH_MAX];
+    static dht_sample_t    smp[DHT_BATCH_MAX];
+
+    int n = journal_peek(ent, DHT_BATCH_MAX);
+    int sent = 0;
+
+    while (sent < n)
+    {
+        int status;
+        int used = 1;
+
+        if (ent[sent].type == JOURNAL_DHT)
+        {
+            used = 0;
+            while (sent + used < n &&
+                   ent[sent + used].type == JOURNAL_DHT &&
+                   ent[sent + used].boot == ent[sent].boot)
+            {
+                const journal_entry_t *e = &ent[sent + used];
+                smp[used] = (dht_sample_t){
+                    .temperature = e->v0 / 100.0f,
+                    .humidity    = e->v1 / 100.0f,
+                    .boot        = e->boot,
+                    .seq         = e->seq,
+                    .t_ms        = e->t_ms,
+                };
+                used++;
+            }
+            status = http_post_dht(smp, used);
+        }
+        else if (ent[sent].type == JOURNAL_POT)
+        {
+            status = http_post_pot_history(&ent[sent]);
+        }
+        else
+        {
+            // tipe tidak dikenal: buang agar antrian tidak macet
+            sent++;
+            continue;
         }
-    };
 
-    esp_wifi_set_mode(WIFI_MODE_STA);
-    esp_wifi_set_config(WIFI_IF_STA, &wifi_cfg);
-    esp_wifi_start();
+        if (!send_ok(status))
+            break;
+        sent += used;
+    }
+
+    journal_consume(sent);
+
+    if (sent)
+        ESP_LOGI(TAG, "Journal replay %d, pending %lu",
+                 sent, (unsigned long)journal_pending());
+
+    return n > 0 && sent == n;
+}
+
+/* ================= BATCH DHT LANGSUNG ================= */
+// gagal kirim / link putus: pindahkan ke journal agar tidak hilang
+static void dht_batch_to_journal(void)
+{
+    if (journal_ready())
+        for (int i = 0; i < dht_batch_len; i++)
+            journal_dht(&dht_batch[i]);
+
+    dht_batch_len = 0;
+}
+
+static void dht_batch_flush(void)
+{
+    if (dht_batch_len == 0)
+        return;
+
+    if (send_ok(http_post_dht(dht_batch, dht_batch_len)))
+        dht_batch_len = 0;
+    else
+        dht_batch_to_journal();
+}
 
-    pot_queue = xQueueCreate(2, sizeof(int));
+// sisa waktu sampai batch harus dikirim
+static TickType_t dht_batch_wait(void)
+{
+    if (dht_batch_len == 0)
+        return portMAX_DELAY;
+
+    uint32_t age = now_ms() - dht_batch[0].t_ms;
+    return (age >= DHT_BATCH_MS) ? 0 : pdMS_TO_TICKS(DHT_BATCH_MS - age);
+}
+
+/* ================= TELEMETRY ================= */
+/* data kontrol cepat basi: hanya lewat WebSocket, tidak masuk journal.
+ * WS putus -> tidak ada fallback HTTP (1 POST/detik), ring menimpa
+ * sampel tertua sendiri sampai WS tersambung lagi */
+static void telem_flush(void)
+{
+    telem_last_ms = now_ms();
+
+    if (!ws_link_connected())
+        return;
+
+    size_t len = telemetry_encode(telem_buf, sizeof(telem_buf), journal_boot());
+    if (len)
+        ws_link_send_telemetry(telem_buf, len);
+}
+
+static TickType_t telem_wait(void)
+{
+    uint32_t age = now_ms() - telem_last_ms;
+    return (age >= TELEM_PERIOD_MS) ? 0 : pdMS_TO_TICKS(TELEM_PERIOD_MS - age);
+}
+
+/* ================= TASK ================= */
+void wifi_http_task(void *pv)
+{
+    dht_data_t   recv;
+    conn_event_t evt;
+    ws_result_t  res;
+    int  pot_event;
+    bool link_up = conn_is_up();
+
+    atomic_store(&http_task, xTaskGetCurrentTaskHandle());
+
+    if (link_up)
+        ws_link_start();
 
     while (1)
     {
-        /* === DHT === */
-        if (xQueueReceive(dht_queue, &recv, 0))
-            http_post_dht(&recv);
+        while (xQueueReceive(conn_queue, &evt, 0))
+        {
+            if (evt == CONN_EVT_UP)
+            {
+                link_up = true;
+                ws_link_start();
+            }
+            else if (evt == CONN_EVT_DOWN)
+            {
+                link_up = false;
+                dht_batch_to_journal();
+            }
+        }
 
-        /* === POT EVENT === */
-        if (xQueueReceive(pot_queue, &pot_event, 0))
+        /* === POT EVENT: selalu didahulukan ===
+         * offline / gagal: ke journal, replay ke /pot/history saja */
+        while (xQueueReceive(pot_queue, &pot_event, 0))
         {
-            ESP_LOGI(TAG, "Pot %d detected", pot_index);
+            if (!link_up || !handle_pot(pot_event))
+                journal_pot(pot_event);
+        }
+
+        while (xQueueReceive(result_queue, &res, 0))
+            handle_result(&res);
+
+        /* === DHT: offline / journal belum kosong -> journal,
+         *     online -> kumpulkan ke batch === */
+        while (xQueueReceive(dht_queue, &recv, 0))
+        {
+            dht_sample_t smp = {
+                .temperature = recv.temperature,
+                .humidity    = recv.humidity,
+                .boot        = journal_boot(),
+                .t_ms        = now_ms(),
+            };
+
+            if (journal_ready() && (!link_up || journal_pending() > 0))
+                journal_dht(&smp);
+            else if (dht_batch_len < DHT_BATCH_MAX)
+                dht_batch[dht_batch_len++] = smp;
+        }
+
+        if (!link_up)
+        {
+            // tanpa journal: batch jatuh tempo dibuang, jangan spin
+            if (dht_batch_wait() == 0)
+                dht_batch_to_journal();
+        }
+        else
+        {
+            // batch penuh / jatuh tempo; pot tidak boleh menunggu di belakang POST DHT
+            if ((dht_batch_len >= DHT_BATCH_MAX || dht_batch_wait() == 0) &&
+                uxQueueMessagesWaiting(pot_queue) == 0)
+                dht_batch_flush();
 
-            if (http_post_pot(pot_index))
+            if (telem_wait() == 0 && uxQueueMessagesWaiting(pot_queue) == 0)
+                telem_flush();
+
+            /* === REPLAY: berurutan, berhenti jika ada pot atau gagal === */
+            while (journal_pending() > 0 && uxQueueMessagesWaiting(pot_queue) == 0)
             {
-                ESP_LOGI(TAG, "Waiting upload...");
-
-                if (wait_upload_done())
-                {
-                    ESP_LOGI(TAG, "Upload OK, continue");
-                    pot_index++;
-                    robot_state = ROBOT_RUN;
-                }
+                if (!journal_drain_batch())
+                    break;
             }
         }
 
-        vTaskDelay(pdMS_TO_TICKS(50));
+        // tidur sampai ada notifikasi producer, batch DHT atau telemetry jatuh tempo
+        TickType_t wait = dht_batch_wait();
+        if (link_up && telem_wait() < wait)
+            wait = telem_wait();
+
+        ulTaskNotifyTake(pdTRUE, wait);
     }
 }
-
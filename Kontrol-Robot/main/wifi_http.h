@@ -1,8 +1,8 @@
 #ifndef WIFI_HTTP_H
 #define WIFI_HTTP_H
 
+#include <stdbool.h>
 #include "esp_err.h"
-#include "freertos/queue.h"
 
 /* ===== DHT DATA ===== */
 typedef struct {
@@ -10,11 +10,17 @@ typedef struct {
     float humidity;
 } dht_data_t;
 
-/* ===== QUEUE ===== */
-extern QueueHandle_t pot_queue;
-
 /* ===== TASK ===== */
-void wifi_http_task(void *pv);
+/* setelah conn_init(), sebelum task producer jalan */
+esp_err_t wifi_http_init(void);
+void      wifi_http_task(void *pv);
+
+/* ===== PRODUCER (task lain) =====
+ * masuk antrian + bangunkan wifi_http_task, tidak blocking.
+ * false jika antrian penuh.
+ */
+bool wifi_http_post_pot(int pot);
+bool wifi_http_post_dht(const dht_data_t *d);
 
 #endif
 
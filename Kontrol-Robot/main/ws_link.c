@@ -0,0 +1,139 @@
+#include "ws_link.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "esp_log.h"
+#include "esp_websocket_client.h"
+#include "cJSON.h"
+
+#include "robot_state.h"
+
+#define TAG "WS_LINK"
+
+#define WS_URI              "ws://leafiot.ksmiotupnvj.com:8000/ws/robot"
+#define WS_RECONNECT_MS     2000
+#define WS_TIMEOUT_MS       5000
+#define WS_PING_SEC         10
+#define WS_SEND_TIMEOUT_MS  1000
+
+static esp_websocket_client_handle_t ws;
+static QueueHandle_t                 results;
+static ws_notify_t                   results_notify;
+static bool                          started;
+
+/* ================= RX ================= */
+// {"type":"analysis","pot":N,"ripe":..,"unripe":..,"total":..}
+// {"type":"resume"}  keluar dari ROBOT_ERROR
+static void ws_handle_text(const char *data, int len)
+{
+    cJSON *root = cJSON_ParseWithLength(data, len);
+    if (!root)
+        return;
+
+    cJSON *type = cJSON_GetObjectItem(root, "type");
+    cJSON *pot  = cJSON_GetObjectItem(root, "pot");
+
+    if (cJSON_IsString(type) && strcmp(type->valuestring, "analysis") == 0 &&
+        cJSON_IsNumber(pot))
+    {
+        cJSON *ripe   = cJSON_GetObjectItem(root, "ripe");
+        cJSON *unripe = cJSON_GetObjectItem(root, "unripe");
+        cJSON *total  = cJSON_GetObjectItem(root, "total");
+
+        ws_result_t r = {
+            .pot    = pot->valueint,
+            .ripe   = cJSON_IsNumber(ripe)   ? ripe->valueint   : 0,
+            .unripe = cJSON_IsNumber(unripe) ? unripe->valueint : 0,
+            .total  = cJSON_IsNumber(total)  ? total->valueint  : 0,
+        };
+
+        if (xQueueSend(results, &r, 0) != pdTRUE)
+            ESP_LOGW(TAG, "Result queue full, pot %d dropped", r.pot);
+        else if (results_notify)
+            results_notify();
+    }
+    else if (cJSON_IsString(type) && strcmp(type->valuestring, "resume") == 0)
+    {
+        robot_event_post(EV_RESUME, 0);
+    }
+
+    cJSON_Delete(root);
+}
+
+static void ws_event(void *arg, esp_event_base_t base, int32_t id, void *data)
+{
+    esp_websocket_event_data_t *ev = data;
+
+    switch (id)
+    {
+        case WEBSOCKET_EVENT_CONNECTED:
+            ESP_LOGI(TAG, "Connected");
+            break;
+
+        case WEBSOCKET_EVENT_DISCONNECTED:
+            ESP_LOGW(TAG, "Disconnected");
+            break;
+
+        case WEBSOCKET_EVENT_DATA:
+            // hanya frame teks utuh (pesan backend kecil)
+            if (ev->op_code == 0x1 && ev->payload_offset == 0 &&
+                ev->data_len == ev->payload_len)
+                ws_handle_text(ev->data_ptr, ev->data_len);
+            break;
+
+        default:
+            break;
+    }
+}
+
+/* ================= INIT ================= */
+esp_err_t ws_link_init(QueueHandle_t result_queue, ws_notify_t on_result)
+{
+    esp_websocket_client_config_t cfg = {
+        .uri                  = WS_URI,
+        .reconnect_timeout_ms = WS_RECONNECT_MS,
+        .network_timeout_ms   = WS_TIMEOUT_MS,
+        .ping_interval_sec    = WS_PING_SEC,
+    };
+
+    results        = result_queue;
+    results_notify = on_result;
+
+    ws = esp_websocket_client_init(&cfg);
+    if (!ws)
+        return ESP_ERR_NO_MEM;
+
+    return esp_websocket_register_events(ws, WEBSOCKET_EVENT_ANY, ws_event, NULL);
+}
+
+void ws_link_start(void)
+{
+    if (ws && !started)
+    {
+        esp_websocket_client_start(ws);
+        started = true;
+    }
+}
+
+bool ws_link_connected(void)
+{
+    return ws && esp_websocket_client_is_connected(ws);
+}
+
+/* ================= TX ================= */
+bool ws_link_send_pot(int pot)
+{
+    char msg[32];
+    int len = snprintf(msg, sizeof(msg), "{\"type\":\"pot\",\"pot\":%d}", pot);
+
+    return ws_link_connected() &&
+           esp_websocket_client_send_text(ws, msg, len,
+                                          pdMS_TO_TICKS(WS_SEND_TIMEOUT_MS)) == len;
+}
+
+bool ws_link_send_telemetry(const uint8_t *buf, size_t len)
+{
+    return ws_link_connected() &&
+           esp_websocket_client_send_bin(ws, (const char *)buf, len,
+                                         pdMS_TO_TICKS(WS_SEND_TIMEOUT_MS)) == (int)len;
+}
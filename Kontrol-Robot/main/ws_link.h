@@ -0,0 +1,38 @@
+#ifndef WS_LINK_H
+#define WS_LINK_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/queue.h"
+
+/* =========================================================
+ *  WEBSOCKET ke backend (/ws/robot), satu koneksi permanen.
+ *  robot -> backend : pot (teks JSON), telemetry (biner)
+ *  backend -> robot : hasil analisis pot, resume (teks JSON)
+ * ========================================================= */
+
+typedef struct {
+    int pot;
+    int ripe;
+    int unripe;
+    int total;
+} ws_result_t;
+
+/* dipanggil dari task websocket setelah hasil masuk queue, harus singkat */
+typedef void (*ws_notify_t)(void);
+
+/* hasil analisis dikirim ke result_queue (elemen ws_result_t), lalu on_result() */
+esp_err_t ws_link_init(QueueHandle_t result_queue, ws_notify_t on_result);
+
+/* mulai konek; reconnect otomatis setelahnya */
+void ws_link_start(void);
+bool ws_link_connected(void);
+
+bool ws_link_send_pot(int pot);
+bool ws_link_send_telemetry(const uint8_t *buf, size_t len);
+
+#endif
@@ -9,6 +9,9 @@
 #include <driver/gpio.h>
 #include <esp_timer.h>
 #include <esp_http_client.h>
+#include <esp_now.h>
+#include <esp_heap_caps.h>
+#include <freertos/queue.h>
 #include <lwip/sockets.h>
 #include <lwip/netdb.h>
 #include "esp_http_server.h"
@@ -288,6 +291,8 @@ static esp_err_t init_camera(void) {
         .frame_size     = FRAMESIZE_UXGA,
         .jpeg_quality   = 12,
         .fb_count       = 2,
+        .fb_location    = CAMERA_FB_IN_PSRAM,
+        .grab_mode      = CAMERA_GRAB_LATEST,   // selalu frame terbaru
     };
 
     esp_err_t err = esp_camera_init(&config);
@@ -307,33 +312,170 @@ static esp_err_t init_camera(void) {
     return ESP_OK;
 }
 
-static void capture_and_upload_task(void *pvParameters) {
+//----ESP-NOW CAPTURE SERVICE------
+// Protokol harus sama dengan Kontrol-Robot/main/espnow_link.h
+#define ESPNOW_PROTO_VER    2
+#define WARM_INTERVAL_MS    500     // ambil & buang frame agar AE/AWB tetap settle
+
+typedef enum {
+    CMD_NONE = 0,
+    CMD_TAKE_PICTURE,
+    CMD_DONE,
+    CMD_ACK
+} cmd_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  ver;
+    uint8_t  cmd;
+    uint16_t seq;
+    uint32_t nonce;     // acak per boot robot
+    uint16_t pot;
+    uint8_t  status;
+} espnow_msg_t;
+
+typedef struct {
+    espnow_msg_t msg;
+    uint8_t      mac[ESP_NOW_ETH_ALEN];
+} cam_cmd_t;
+
+typedef struct {
+    uint8_t *buf;
+    size_t   len;
+    uint16_t pot;
+} upload_job_t;
+
+static QueueHandle_t cmd_queue;
+static QueueHandle_t upload_queue;
+
+static void espnow_recv_cb(const esp_now_recv_info_t *info, const uint8_t *data, int len) {
+    if (len != sizeof(espnow_msg_t)) return;
+
+    cam_cmd_t c;
+    memcpy(&c.msg, data, sizeof(c.msg));
+    memcpy(c.mac, info->src_addr, ESP_NOW_ETH_ALEN);
+
+    if (c.msg.ver != ESPNOW_PROTO_VER) return;
+    xQueueSend(cmd_queue, &c, 0);
+}
+
+static void espnow_reply(const cam_cmd_t *c, uint8_t cmd, uint8_t status) {
+    if (!esp_now_is_peer_exist(c->mac)) {
+        esp_now_peer_info_t peer = {0};
+        memcpy(peer.peer_addr, c->mac, ESP_NOW_ETH_ALEN);
+        peer.channel = 0;       // channel AP saat ini
+        peer.encrypt = false;
+        esp_now_add_peer(&peer);
+    }
+
+    espnow_msg_t msg = {
+        .ver    = ESPNOW_PROTO_VER,
+        .cmd    = cmd,
+        .seq    = c->msg.seq,
+        .nonce  = c->msg.nonce,
+        .pot    = c->msg.pot,
+        .status = status,
+    };
+    esp_now_send(c->mac, (const uint8_t *)&msg, sizeof(msg));
+}
+
+static void init_espnow(void) {
+    cmd_queue    = xQueueCreate(4, sizeof(cam_cmd_t));
+    upload_queue = xQueueCreate(2, sizeof(upload_job_t));
+
+    esp_wifi_set_ps(WIFI_PS_NONE);   // modem sleep bikin ESP-NOW telat/hilang
+    esp_now_init();
+    esp_now_register_recv_cb(espnow_recv_cb);
+    ESP_LOGI(TAG, "ESP-NOW capture service ready");
+}
+
+// Capture saat perintah datang, DONE dikirim begitu frame ada di memori.
+// Upload dikerjakan upload_task, robot tidak menunggu jaringan.
+static void capture_service_task(void *pvParameters) {
+    cam_cmd_t c;
+    bool     have_last   = false;
+    uint8_t  last_mac[ESP_NOW_ETH_ALEN];
+    uint32_t last_nonce  = 0;
+    uint16_t last_seq    = 0;
+    uint8_t  last_status = 0;
+
     while (1) {
+        if (!xQueueReceive(cmd_queue, &c, pdMS_TO_TICKS(WARM_INTERVAL_MS))) {
+            camera_fb_t *fb = esp_camera_fb_get();
+            if (fb) esp_camera_fb_return(fb);
+            continue;
+        }
 
-        blink_led_success();                  // <--- Tambahan
-        vTaskDelay(pdMS_TO_TICKS(200));       // Delay kecil biar lampu sempat menyala
+        if (c.msg.cmd != CMD_TAKE_PICTURE) continue;
 
+        // retransmit dari robot: jawab ulang, jangan capture lagi.
+        // nonce beda = robot reboot, seq boleh sama tapi perintah baru
+        if (have_last && c.msg.seq == last_seq && c.msg.nonce == last_nonce &&
+            memcmp(c.mac, last_mac, ESP_NOW_ETH_ALEN) == 0) {
+            espnow_reply(&c, CMD_DONE, last_status);
+            continue;
+        }
+
+        espnow_reply(&c, CMD_ACK, 0);
+
+        // buang frame lama yang mungkin masih di buffer
         camera_fb_t *fb = esp_camera_fb_get();
+        if (fb) esp_camera_fb_return(fb);
+
+        fb = esp_camera_fb_get();
+        uint8_t status = fb ? 0 : 1;
+
+        have_last   = true;
+        memcpy(last_mac, c.mac, ESP_NOW_ETH_ALEN);
+        last_nonce  = c.msg.nonce;
+        last_seq    = c.msg.seq;
+        last_status = status;
+
+        espnow_reply(&c, CMD_DONE, status);
+
         if (!fb) {
-            ESP_LOGE(TAG, "Failed to capture image");
-            blink_led_error();
-            vTaskDelay(pdMS_TO_TICKS(2000));
+            ESP_LOGE(TAG, "Failed to capture image (pot %u)", c.msg.pot);
             continue;
         }
 
-        if (upload_image(fb->buf, fb->len) == ESP_OK) {
-            ESP_LOGI(TAG, "Upload sukses");
-            blink_led_success();
+        ESP_LOGI(TAG, "Pot %u captured (%u bytes)", c.msg.pot, (unsigned)fb->len);
+
+        upload_job_t job = {
+            .buf = heap_caps_malloc(fb->len, MALLOC_CAP_SPIRAM),
+            .len = fb->len,
+            .pot = c.msg.pot,
+        };
+
+        if (job.buf) {
+            memcpy(job.buf, fb->buf, fb->len);
+            if (xQueueSend(upload_queue, &job, 0) != pdTRUE) {
+                ESP_LOGW(TAG, "Upload queue penuh, pot %u dilewati", job.pot);
+                heap_caps_free(job.buf);
+            }
         } else {
-            ESP_LOGE(TAG, "Upload gagal");
-            blink_led_error();
+            ESP_LOGE(TAG, "No PSRAM for upload copy");
         }
 
         esp_camera_fb_return(fb);
-        vTaskDelay(pdMS_TO_TICKS(3000));
     }
 }
 
+static void upload_task(void *pvParameters) {
+    upload_job_t job;
+
+    while (1) {
+        xQueueReceive(upload_queue, &job, portMAX_DELAY);
+
+        if (upload_image(job.buf, job.len) == ESP_OK) {
+            ESP_LOGI(TAG, "Upload sukses (pot %u)", job.pot);
+            blink_led_success();
+        } else {
+            ESP_LOGE(TAG, "Upload gagal (pot %u)", job.pot);
+            blink_led_error();
+        }
+
+        heap_caps_free(job.buf);
+    }
+}
 
 /*
 //----ESP kirim status Heartbeat (PING) ke backend-------
@@ -428,7 +570,9 @@ void app_main(void) {
     connect_wifi();
     test_dns_resolution();
     init_camera();
-    xTaskCreate(capture_and_upload_task, "capture_and_upload_task", 8192, NULL, 3, NULL);
+    init_espnow();
+    xTaskCreate(capture_service_task, "capture_service_task", 4096, NULL, 4, NULL);
+    xTaskCreate(upload_task, "upload_task", 8192, NULL, 3, NULL);
     //xTaskCreate(task_heartbeat, "task_heartbeat", 4096, NULL, 2, NULL);
     xTaskCreate(ota_server_task, "ota_server_task", 4096, NULL, 1, NULL);
 }